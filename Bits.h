@@ -0,0 +1,121 @@
+/*!
+  \file Bits.h
+  \brief Funzioni di supporto per la rappresentazione compatta delle celle
+  \date 17-10-2026
+*/
+
+#ifndef _BITS_H
+#define _BITS_H 1
+
+#include <stdint.h>
+
+
+namespace gameoflife {
+
+/*!
+  \typedef word_t
+  \brief Parola macchina che contiene lo stato di WORD_BITS celle.
+
+  Le celle sono memorizzate un bit per cella: la cella di indice j si trova
+  nel bit (j % WORD_BITS) della parola (j / WORD_BITS). Un bit a 1 rappresenta
+  una cella viva, un bit a 0 una cella morta.
+*/
+typedef uint64_t word_t;
+
+//! Numero di celle contenute in una parola.
+const unsigned int WORD_BITS = 64;
+
+/**
+ * Restituisce il numero di parole necessarie per memorizzare n celle.
+ */
+inline unsigned int wordsFor(unsigned int n) {
+  return (n + WORD_BITS - 1) / WORD_BITS;
+} // end of function wordsFor
+
+/**
+ * Restituisce una maschera con gli n bit meno significativi a 1 (n <= 64).
+ */
+inline word_t lowMask(unsigned int n) {
+  return (n >= WORD_BITS ? ~word_t(0) : (word_t(1) << n) - 1);
+} // end of function lowMask
+
+/**
+ * Restituisce il valore della cella di indice i.
+ */
+inline bool getBit(const word_t* v, unsigned int i) {
+  return (v[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+} // end of function getBit
+
+/**
+ * Imposta il valore della cella di indice i.
+ */
+inline void setBit(word_t* v, unsigned int i, bool value) {
+  word_t mask = word_t(1) << (i % WORD_BITS);
+  if(value) v[i / WORD_BITS] |= mask;
+  else v[i / WORD_BITS] &= ~mask;
+  return;
+} // end of function setBit
+
+/**
+ * Restituisce gli n bit (n <= 64) a partire dalla posizione pos, allineati
+ * al bit meno significativo. Legge la parola successiva solo se necessario.
+ */
+inline word_t getBits(const word_t* v, unsigned int pos, unsigned int n) {
+  unsigned int w = pos / WORD_BITS;
+  unsigned int off = pos % WORD_BITS;
+  word_t bits = v[w] >> off;
+  if(off != 0 && off + n > WORD_BITS)
+    bits |= v[w+1] << (WORD_BITS - off);
+  return bits & lowMask(n);
+} // end of function getBits
+
+/**
+ * Scrive gli n bit meno significativi di bits (n <= 64) a partire dalla
+ * posizione pos, lasciando inalterati gli altri bit.
+ */
+inline void setBits(word_t* v, unsigned int pos, unsigned int n, word_t bits) {
+  unsigned int w = pos / WORD_BITS;
+  unsigned int off = pos % WORD_BITS;
+  word_t mask = lowMask(n);
+  bits &= mask;
+  v[w] = (v[w] & ~(mask << off)) | (bits << off);
+  if(off != 0 && off + n > WORD_BITS) {
+    unsigned int shift = WORD_BITS - off;
+    v[w+1] = (v[w+1] & ~(mask >> shift)) | (bits >> shift);
+  }
+  return;
+} // end of function setBits
+
+/**
+ * Copia n celle dalla posizione srcPos di src alla posizione dstPos di dst.
+ */
+inline void copyBits(word_t* dst, unsigned int dstPos,
+    const word_t* src, unsigned int srcPos, unsigned int n) {
+  while(n > 0) {
+    unsigned int len = (n < WORD_BITS ? n : WORD_BITS);
+    setBits(dst, dstPos, len, getBits(src, srcPos, len));
+    dstPos += len;
+    srcPos += len;
+    n -= len;
+  } // end while
+  return;
+} // end of function copyBits
+
+/**
+ * Restituisce il contributo della parola bits, di indice index, all'hash di
+ * una matrice, pari alla somma dei contributi delle sue parole: cosi' le
+ * parole possono essere sommate in qualsiasi ordine, e l'hash di piu'
+ * blocchi e' la somma dei loro hash. Le parole a zero non contribuiscono.
+ */
+inline uint64_t hashWord(word_t bits, uint64_t index) {
+  uint64_t h = bits ^ (index * 0x9e3779b97f4a7c15ULL);
+  h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdULL;
+  h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (bits == 0 ? 0 : h);
+} // end of function hashWord
+
+} // end of namespace gameoflife
+
+
+#endif // _BITS_H
@@ -8,147 +8,978 @@
 #ifndef _BLOCK_H
 #define _BLOCK_H 1
 
+#include <algorithm>
+#include <climits>
 #include <iostream>
 #include <cstring>
+#include <vector>
+#include <unistd.h>
 #include "Muesli.h"
+#include "Bits.h"
+#include "Kernel.h"
+#include "LargerThanLife.h"
+#include "Simd.h"
+#include "Slice.h"
+#include "Sparse.h"
+#include "Stats.h"
 #include "Vector.h"
 
 
 namespace gameoflife {
 
+//! Righe di celle di una tessera (ENGINE_TILED).
+const unsigned int TILE_ROWS = 32;
+
+//! Parole di celle di ogni riga di una tessera (ENGINE_TILED).
+const unsigned int TILE_WORDS = 2;
+
+//! Tessera diversa dalla generazione precedente.
+const unsigned char CHANGED_1 = 1;
+
+//! Tessera diversa da due generazioni prima (non e' ferma con periodo 2).
+const unsigned char CHANGED_2 = 2;
+
+//! Densita' oltre la quale ENGINE_AUTO passa da ENGINE_SPARSE a ENGINE_TILED
+//! (e sotto la cui meta' torna a ENGINE_SPARSE). Il kernel bit a bit
+//! calcola decine di miliardi di celle al secondo, per cui ENGINE_SPARSE
+//! conviene solo con meno di una cella viva ogni mille circa.
+const double SPARSE_DENSITY = 0.0005;
+
+//! Generazioni tra due misure della popolazione con ENGINE_AUTO (TILED).
+const unsigned int AUTO_PERIOD = 64;
+
+//! Dimensione in byte della cache di secondo livello, se non rilevabile.
+const long L2_CACHE = 256 * 1024;
+
+//! Parole di celle di ogni riga di una tessera della tassellazione
+//! temporale (vedi Block::advance), comprese quelle dei bordi.
+const unsigned int TEMPORAL_WORDS = 512;
+
+/**
+ * Restituisce la dimensione in byte della cache di secondo livello.
+ */
+inline long detectCacheSize() {
+  static long cache = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  if(cache == 0) cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+  if(cache <= 0) cache = L2_CACHE;
+  return cache;
+} // end of function detectCacheSize
+
+/**
+ * Restituisce la larghezza in parole delle strisce di colonne in cui
+ * ENGINE_BITWISE percorre il blocco: le quattro righe di una striscia su cui
+ * lavora il kernel (le tre lette e quella scritta) occupano un quarto della
+ * cache di secondo livello, per cui ogni riga letta resta in cache tra il
+ * primo e il terzo utilizzo anche con righe molto lunghe.
+ */
+inline unsigned int detectStripWords() {
+  unsigned int words = detectCacheSize() / 4 / (4 * sizeof(word_t));
+  return (words + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+} // end of function detectStripWords
+
+/*!
+  \struct LiveBox
+  \brief Rettangolo che contiene le celle vive di una Slice.
+
+  Le righe vanno da top a bottom e le parole da left a right, comprese
+  quelle delle colonne fantasma (con indici negativi a sinistra). Il
+  rettangolo e' vuoto se top > bottom.
+*/
+struct LiveBox {
+
+  int top, bottom;
+  int left, right;
+
+  /**
+   * Svuota il rettangolo.
+   */
+  void clear() {
+    top = left = INT_MAX;
+    bottom = right = INT_MIN;
+    return;
+  } // end of method clear
+
+  /**
+   * Restituisce true se il rettangolo e' vuoto.
+   */
+  bool isEmpty() const {
+    return top > bottom;
+  } // end of method isEmpty
+
+  /**
+   * Estende il rettangolo alla parola w della riga i.
+   */
+  void add(int i, int w) {
+    top = std::min(top, i);
+    bottom = std::max(bottom, i);
+    left = std::min(left, w);
+    right = std::max(right, w);
+    return;
+  } // end of method add
+
+  /**
+   * Estende il rettangolo al rettangolo box.
+   */
+  void add(const LiveBox& box) {
+    if(box.isEmpty()) return;
+    add(box.top, box.left);
+    add(box.bottom, box.right);
+    return;
+  } // end of method add
+
+  /**
+   * Estende il rettangolo alle parole diverse da zero tra begin ed end-1
+   * della riga i, il cui contenuto e' row.
+   */
+  void addWords(int i, const word_t* row, int begin, int end) {
+    int w = begin;
+    while(w < end && row[w] == 0) w++;
+    if(w == end) return;
+    add(i, w);
+    for(w = end - 1; row[w] == 0; --w) ;
+    add(i, w);
+    return;
+  } // end of method addWords
+
+  /**
+   * Azzera le parole di s nel rettangolo che non si trovano tra le righe
+   * da up a down e tra le parole da first a last.
+   */
+  void clearOutside(Slice& s, int up, int down, int first, int last) const {
+    for(int i=top; i <= bottom; ++i) {
+      word_t* row = s.row(i);
+      if(i < up || i > down) {
+        memset(row + left, 0, sizeof(word_t) * (right - left + 1));
+        continue;
+      }
+      for(int w = left; w <= right && w < first; ++w) row[w] = 0;
+      for(int w = std::max(left, last + 1); w <= right; ++w) row[w] = 0;
+    } // end for i
+    return;
+  } // end of method clearOutside
+
+}; // end of struct LiveBox
+
 /*!
   \class Block
   \brief Un blocco in cui suddividere la matrice del gioco della vita.
 
   Rappresenta un blocco della matrice del gioco della vita, utilizzato per
-  l'esecuzione in parallelo. Implementa l'interfaccia MSL_Serializable per 
-  poter essere utilizzato come input e output negli skeleton della libreria 
-  Muesli.
+  l'esecuzione in parallelo. Implementa l'interfaccia MSL_Serializable per
+  poter essere utilizzato come input e output negli skeleton della libreria
+  Muesli. Le celle sono memorizzate in una Slice, la cui cornice fantasma
+  contiene a sinistra e a destra le colonne dei blocchi vicini (i vettori) e
+  sopra e sotto le righe all'estremo opposto del blocco.
+
+  La cornice e' profonda _depth colonne: ricevuti i vettori, il blocco
+  calcola _depth generazioni senza sincronizzarsi, calcolando anche le
+  colonne fantasma che restano valide (una in meno per lato ad ogni
+  generazione), e solo allora ha bisogno di nuovi vettori (vedi needsSynch).
+  Queste generazioni possono essere calcolate una tessera alla volta, finche'
+  la tessera resta in cache (vedi advance e setTemporal). Con una regola
+  Larger than Life di raggio r (vedi activeLtlRule) ogni generazione consuma
+  r colonne per lato, e le generazioni tra due sincronizzazioni sono
+  _depth/r.
 */
 class Block : public MSL_Serializable {
-    
+
   // PRIVATE MEMBERS
   private:
-    
+
     unsigned int _n;    // numero del blocco
     unsigned int _pos;  // posizione del blocco nella matrice
     unsigned int _rows; // numero di righe
     unsigned int _cols; // numero di colone
-    
-    bool** _slice;   // _slice[_rows][_cols]
-    
-    Vector* _leftv;  // _leftv[_rows]
-    Vector* _rightv; // _rightv[_rows]
-    
+    unsigned int _depth; // colonne fantasma per lato
+    unsigned int _step;  // generazioni calcolate dall'ultima sincronizzazione
+                         // (modulo getPeriod())
+
+    Slice* _slice;   // generazione corrente, con i vettori nelle colonne
+                     // fantasma
+    Slice* _next;    // generazione successiva
+
+    Engine _engine;  // motore utilizzato da compute (non serializzato)
+    unsigned int _threads; // thread di ENGINE_BITWISE (non serializzato)
+    unsigned int _strip; // parole per striscia di colonne, 0 per righe
+                         // intere (BITWISE, non serializzato)
+    bool _temporal;      // true per la tassellazione temporale (BITWISE,
+                         // non serializzato)
+    std::vector<word_t> _wave[2]; // generazioni di una tessera (temporale)
+    bool _statsEnabled;  // true se compute calcola _stats (non serializzato)
+    Vector _boundary[2]; // bordi sinistro e destro da spedire ai vicini
+    bool _boundaryValid; // true se _boundary corrisponde a _slice
+    LiveBox _box;        // celle vive di _slice (BITWISE)
+    LiveBox _nextBox;    // celle vive di _next (BITWISE)
+    bool _boxValid;      // true se _box e' noto
+    bool _nextBoxValid;  // true se _nextBox e' noto
+    bool _hashEnabled;   // true se compute calcola _hash (non serializzato)
+    uint64_t _hash;      // hash di _slice (vedi getHash)
+    bool _hashValid;     // true se _hash corrisponde a _slice
+    Stats _stats;        // statistiche dell'ultima generazione calcolata
+
+    unsigned long _allocations; // numero di matrici allocate dal blocco
+
+    std::vector<unsigned char> _cells; // righe un byte per cella (SPLIT)
+
+    unsigned int _tileRows; // righe di tessere (TILED)
+    unsigned int _tileCols; // colonne di tessere (TILED)
+    unsigned int _tracked;  // generazioni consecutive (fino a 2) calcolate
+                            // con ENGINE_TILED
+    std::vector<unsigned char> _changed; // CHANGED_1 e CHANGED_2 di ogni
+                                         // tessera
+    std::vector<unsigned char> _halo;    // CHANGED_1 e CHANGED_2 della
+                                         // colonna fantasma sinistra (prima
+                                         // meta') e destra di ogni riga di
+                                         // tessere
+    std::vector<unsigned char> _active;  // tessere da ricalcolare
+    std::vector<word_t> _scratch;        // differenze di ogni parola (TILED)
+
+    LiveCells _live;      // celle vive di _slice (SPARSE)
+    LiveCells _livePrev;  // celle vive di _next
+    bool _liveValid;      // true se _live corrisponde a _slice
+    bool _prevValid;      // true se _livePrev corrisponde a _next
+    std::vector<unsigned char> _counts;  // vicini di ogni colonna (SPARSE)
+    std::vector<unsigned int> _touched;  // colonne con vicini (SPARSE)
+    std::vector<unsigned char> _ltlSums;    // somme orizzontali (Larger
+                                            // than Life)
+    std::vector<unsigned short> _ltlCounts; // vicini di una riga (Larger
+                                            // than Life)
+    unsigned int _untilCheck; // generazioni alla prossima misura (AUTO)
+
   // PRIVATE METHODS
   private:
-    
-    /* 
-      Elimina la matrice _slice
+
+    /*
+      Alloca una nuova matrice _rows x _cols con tutte le celle morte
+    */
+    Slice* newSlice() {
+      _allocations++;
+      return new Slice(_rows, _cols, _depth, _threads);
+    } // end of method newSlice
+
+    /*
+      Restituisce il numero di elementi per colonna nei vettori (i bordi e
+      le colonne fantasma): _rows arrotondato a un multiplo di WORD_BITS,
+      cosi' ogni colonna inizia in una nuova parola e i thread che scrivono
+      fasce di righe diverse (vedi bandRows) non scrivono mai la stessa
+      parola.
+    */
+    unsigned int columnBits() const {
+      return wordsFor(_rows) * WORD_BITS;
+    } // end of method columnBits
+
+    /*
+      Dimensiona i bordi da spedire per il blocco corrente, che verranno
+      copiati da _slice quando saranno richiesti.
+    */
+    void resetBoundary() {
+      _boundary[0] = Vector(_depth * columnBits());
+      _boundary[1] = Vector(_depth * columnBits());
+      _boundaryValid = false;
+      return;
+    } // end of method resetBoundary
+
+    /*
+      Copia in _boundary gli elementi della riga i di s: quelli del bordo
+      sinistro se left, quelli del bordo destro se right.
     */
-    void deleteSlice() {
-      for(int i=0; i < _rows; ++i)
-        delete[] _slice[i];
-      delete[] _slice;
+    void copyBoundary(const Slice& s, unsigned int i, bool left, bool right) {
+      for(unsigned int c=0; c < _depth; ++c) {
+        unsigned int k = c * columnBits() + i;
+        if(left) _boundary[0].set(k, s.get(i, c));
+        if(right) _boundary[1].set(k, s.get(i, _cols - _depth + c));
+      } // end for c
       return;
-    } // end of method deleteBlock
+    } // end of method copyBoundary
 
-    /* 
-      Restituisce il numero di vicini vivi della cella con indice i,j
+    /*
+      Dimensiona le tessere per il blocco corrente. Finche' non viene
+      calcolata una generazione con ENGINE_TILED tutte le tessere sono
+      considerate cambiate.
     */
-    int getNeighborsCount(unsigned int i, unsigned int j) const {
-      unsigned int count = 0;
-      unsigned int row;
-      
-      // Vicini nella riga sopra (row := i-1)
-      row = (i == 0 ? _rows-1 : i-1);
-      if(j == 0) { if(_leftv->get(row)) count++; }
-      else { if(_slice[row][j-1]) count++; }
-      if(_slice[row][j]) count++;
-      if(j == _cols-1) { if(_rightv->get(row)) count++; }
-      else { if(_slice[row][j+1]) count++; }
-      
-      // Vicini sulla stessa riga (row := i)
-      if(j == 0) { if(_leftv->get(i)) count++; }
-      else { if(_slice[i][j-1]) count++; }
-      if(j == _cols-1) { if(_rightv->get(i)) count++; }
-      else { if(_slice[i][j+1]) count++; }
-
-      // Vicini nella riga sotto (row := i+1)
-      row = (i == _rows-1 ? 0 : i+1);
-      if(j == 0) { if(_leftv->get(row)) count++; }
-      else { if(_slice[row][j-1]) count++; }
-      if(_slice[row][j]) count++;
-      if(j == _cols-1) { if(_rightv->get(row)) count++; }
-      else { if(_slice[row][j+1]) count++; }
-      
-      return count;
+    void resetTiles() {
+      _tileRows = (_rows + TILE_ROWS - 1) / TILE_ROWS;
+      _tileCols = (wordsFor(_cols) + TILE_WORDS - 1) / TILE_WORDS;
+      _changed.assign(_tileRows * _tileCols, CHANGED_1 | CHANGED_2);
+      _active.assign(_tileRows * _tileCols, 1);
+      _halo.assign(2 * _tileRows, CHANGED_1 | CHANGED_2);
+      _scratch.assign(2*wordsFor(_cols), 0);
+      _tracked = 0;
+      _liveValid = _prevValid = false;
+      _untilCheck = 0;
+      return;
+    } // end of method resetTiles
+
+    /*
+      Restituisce il numero di vicini vivi della cella con indice i,j, le cui
+      righe sopra e sotto sono up e down
+    */
+    int getNeighborsCount(int up, int i, int down, int j) const {
+      int count = 0;
+      for(int dj=-1; dj <= 1; ++dj)
+        count += _slice->get(up, j+dj) + _slice->get(down, j+dj);
+      return count + _slice->get(i, j-1) + _slice->get(i, j+1);
     } // end of method getNeighborsCount
-    
-    /* 
-     Restituisce il valore della generazione successiva della cella i,j.
+
+    /*
+     Restituisce il valore della generazione successiva della cella i,j, le
+     cui righe sopra e sotto sono up e down, con la regola restituita da
+     activeRule.
     */
-    bool getNextValue(unsigned int i, unsigned int j) const {
-      int neighbors = getNeighborsCount(i,j);
-      return _slice[i][j] ? 
-          (neighbors == 2 || neighbors == 3) : 
-          (neighbors == 3) ;
+    bool getNextValue(int up, int i, int down, int j) const {
+      int neighbors = getNeighborsCount(up, i, down, j);
+      return activeRule().next(_slice->get(i,j), neighbors);
     } // end of method getNextValue
 
+    /*
+     Calcola la generazione successiva della riga i, una cella alla volta
+     (ENGINE_SCALAR).
+    */
+    void computeRowScalar(unsigned int i) {
+      _next->clearRow(i);
+      word_t* out = _next->row(i);
+      for(unsigned int j=0; j < _cols; ++j)
+        if(getNextValue(i-1, i, i+1, j)) setBit(out, j, true);
+      return;
+    } // end of method computeRowScalar
+
+    /*
+     Calcola la generazione successiva separando le celle interne da quelle
+     di bordo (ENGINE_SPLIT). Le celle interne (righe da 1 a _rows-2, colonne
+     da 1 a _cols-2) sono calcolate da nextCells su righe un byte per cella;
+     le celle di bordo una alla volta, leggendo i vettori nelle colonne
+     fantasma e le righe all'estremo opposto del blocco (per cui non servono
+     le righe fantasma).
+    */
+    void computeSplit() {
+      const Rule& rule = activeRule();
+      _cells.resize(4*_cols);
+      unsigned char* up = &_cells[0];
+      unsigned char* mid = up + _cols;
+      unsigned char* down = mid + _cols;
+      unsigned char* next = down + _cols;
+      unpackCells(_slice->row(0), up, _cols);
+      unpackCells(_slice->row(1), mid, _cols);
+      for(unsigned int i=1; i+1 < _rows; ++i) {
+        // Celle interne
+        unpackCells(_slice->row(i+1), down, _cols);
+        nextCells(up, mid, down, next, _cols, rule);
+        if(_cols > 2) packCells(next, _next->row(i), 1, _cols-1);
+        // Prima e ultima colonna
+        _next->set(i, 0, getNextValue(i-1, i, i+1, 0));
+        _next->set(i, _cols-1, getNextValue(i-1, i, i+1, _cols-1));
+        unsigned char* tmp = up;
+        up = mid;
+        mid = down;
+        down = tmp;
+      } // end for i
+      // Prima e ultima riga
+      int last = _rows-1;
+      for(unsigned int j=0; j < _cols; ++j) {
+        _next->set(0, j, getNextValue(last, 0, 1, j));
+        _next->set(last, j, getNextValue(last-1, last, 0, j));
+      } // end for j
+      return;
+    } // end of method computeSplit
+
+    /*
+     Calcola la generazione successiva WORD_BITS celle alla volta
+     (ENGINE_BITWISE), a strisce di _strip parole: ogni striscia viene
+     percorsa dalla prima all'ultima riga prima di passare alla successiva,
+     cosi' le righe di una striscia restano in cache anche quando le righe
+     intere non ci stanno.
+
+     Se dopo questa generazione il blocco deve sincronizzarsi, copia in
+     _boundary i bordi da spedire riga per riga, appena calcolati (con le
+     strisce, dopo la striscia che contiene l'ultima parola di ogni bordo).
+
+     Se sono noti i rettangoli delle celle vive di _slice e _next (vedi
+     LiveBox) e con la regola in uso le celle senza vicini vivi restano
+     morte, calcola solo il rettangolo di _slice con una riga e una parola
+     in piu' per lato, azzerando in _next le celle vive fuori da esso: con
+     una popolazione piccola e concentrata il costo non dipende dalla
+     dimensione del blocco, e un blocco senza celle vive non calcola nulla.
+     Il rettangolo delle celle vive di _next viene calcolato insieme alle
+     righe.
+
+     Con _depth > 1 calcola anche le colonne fantasma ancora valide dopo
+     questa generazione (e per lato), cioe' le parole intere che le
+     contengono: le celle piu' esterne sono errate, ma si trovano fuori
+     dalla regione valida, che si restringe piu' velocemente di quanto
+     l'errore si propaghi.
+    */
+    void computeBitwise() {
+      unsigned int e = (_step + 1 < _depth ? _depth - 1 - _step : 0);
+      int lo = -(int)((e + WORD_BITS - 1) / WORD_BITS);
+      int hi = (_cols + e - 1) / WORD_BITS;
+      unsigned int words = hi - lo + 1;
+      unsigned int lastBit = (e == 0 ? (_cols-1) % WORD_BITS : WORD_BITS-1);
+      unsigned int strip = (_strip == 0 ? words : _strip);
+      bool capture = (_step + 1 == _depth);
+      int leftWord = (_depth - 1) / WORD_BITS;
+      int rightWord = (_cols - 1) / WORD_BITS;
+      // Regione da calcolare: righe da top a bottom, parole da first a last
+      int top = 0, bottom = _rows - 1, first = lo, last = hi;
+      if(_boxValid && _nextBoxValid && sparseSupported(activeRule())) {
+        if(_box.isEmpty()) bottom = -1;
+        else {
+          // Il rettangolo si chiude sul toro solo se tocca il bordo
+          if(_box.top > 0 && _box.bottom < (int)_rows - 1) {
+            top = _box.top - 1;
+            bottom = _box.bottom + 1;
+          }
+          first = std::max(_box.left - 1, lo);
+          last = std::min(_box.right + 1, hi);
+        }
+        _nextBox.clearOutside(*_next, top, bottom, first, last);
+        // Le righe non calcolate hanno i bordi vuoti
+        if(capture && (top > 0 || bottom < (int)_rows - 1 || first > lo ||
+            last < hi)) {
+          _boundary[0].clear();
+          _boundary[1].clear();
+        }
+      }
+      _nextBox.clear();
+      bool hash = (_hashEnabled && capture);
+      _hash = 0;
+      // Ogni thread calcola la propria fascia di righe (vedi bandRows)
+      unsigned int band = bandRows(_rows, _threads);
+      #pragma omp parallel for num_threads(_threads) schedule(static, 1)
+      for(unsigned int t=0; t < _threads; ++t) {
+        int from = std::max(top, (int)(t * band));
+        int to = std::min(bottom, (int)((t + 1) * band) - 1);
+        LiveBox box;
+        Stats stats;
+        uint64_t h = 0;
+        box.clear();
+        stats.clear();
+        for(int w = first - lo; w <= last - lo && from <= to; w += strip) {
+          int begin = lo + w, end = std::min(begin + (int)strip, last + 1);
+          bool left = capture && begin <= leftWord && leftWord < end;
+          bool right = capture && begin <= rightWord && rightWord < end;
+          for(int i=from; i <= to; ++i) {
+            nextRow(_slice->row(i-1) + lo, _slice->row(i) + lo,
+                _slice->row(i+1) + lo, words, lastBit, _next->row(i) + lo,
+                w, end - lo);
+            if(left || right) copyBoundary(*_next, i, left, right);
+            // Le parole appena calcolate sono ancora in cache
+            box.addWords(i, _next->row(i), begin, end);
+            if(hash) h += hashWords(*_next, i, begin, end);
+            if(_statsEnabled)
+              stats.addWords(i, _slice->row(i), _next->row(i),
+                  std::max(begin, 0), std::max(end, 0), _cols, _pos);
+          } // end for i
+        } // end for w
+        #pragma omp critical
+        {
+          _nextBox.add(box);
+          _hash += h;
+          _stats.add(stats);
+        }
+      } // end for t
+      _nextBoxValid = true;
+      return;
+    } // end of method computeBitwise
+
+    /*
+     Calcola la generazione successiva con la regola Larger than Life
+     restituita da activeLtlRule, qualunque sia il motore. Come in
+     computeBitwise vengono calcolate anche le colonne fantasma che restano
+     valide, r in meno per lato ad ogni generazione.
+    */
+    void computeLtl() {
+      const LtlRule& rule = activeLtlRule();
+      unsigned int e = _depth - (_step + 1) * rule.radius;
+      nextLargerThanLife(*_slice, *_next, rule, e, _ltlSums, _ltlCounts);
+      return;
+    } // end of method computeLtl
+
+    /*
+     Calcola n generazioni (ENGINE_BITWISE, con n da 2 alla prossima
+     sincronizzazione) una tessera alla volta. Ogni tessera, di
+     TEMPORAL_WORDS parole (bordi compresi) per il numero di righe con cui
+     due sue copie occupano meta' della cache di secondo livello, viene
+     fatta avanzare di n generazioni insieme a n righe e n colonne in piu'
+     per lato (le righe si chiudono in modo toroidale, le colonne sono quelle
+     dei vicini o quelle fantasma): ad ogni generazione la parte valida si
+     restringe di una riga e una colonna per lato, e dopo n generazioni
+     coincide con la tessera. La prima generazione legge da _slice, quelle
+     intermedie si alternano in _wave e l'ultima scrive in _next, per cui
+     ogni cella di _slice e _next viene letta o scritta una sola volta ogni
+     n generazioni, al prezzo di calcolare piu' volte le celle dei bordi.
+     Come in computeBitwise, vengono calcolate anche le colonne fantasma che
+     restano valide.
+    */
+    void computeTemporal(unsigned int n) {
+      unsigned int e = _depth - _step - n;
+      int lo = -(int)((e + WORD_BITS - 1) / WORD_BITS);
+      int hi = (_cols + e - 1) / WORD_BITS;
+      unsigned int words = hi - lo + 1;
+      unsigned int p = (n + WORD_BITS - 1) / WORD_BITS; // parole per bordo
+      unsigned int width = (TEMPORAL_WORDS > 2*p + LINE_WORDS ?
+          TEMPORAL_WORDS - 2*p : LINE_WORDS);     // parole senza i bordi
+      unsigned int stride = width + 2*p + 2;      // con due di riserva
+      unsigned int tileRows = detectCacheSize() / 2 / 
+          (2 * stride * sizeof(word_t));
+      tileRows = std::min(tileRows > 4*n ? tileRows - 2*n : 2*n, _rows);
+      for(unsigned int b=0; b < 2; ++b)
+        _wave[b].resize((tileRows + 2*n) * stride);
+      std::vector<const word_t*> in(tileRows + 2*n);
+      for(unsigned int r0=0; r0 < _rows; r0 += tileRows) {
+        unsigned int rows = std::min(tileRows, _rows - r0);
+        for(unsigned int w0=0; w0 < words; w0 += width) {
+          unsigned int tw = std::min(width, words - w0);
+          unsigned int tileWords = tw + 2*p;
+          // Righe di _slice della tessera e dei suoi bordi
+          for(unsigned int i=0; i < rows + 2*n; ++i)
+            in[i] = _slice->row((r0 + i + _rows - n % _rows) % _rows) +
+                lo + w0 - p;
+          for(unsigned int t=1; t <= n; ++t) {
+            const word_t* src = &_wave[t % 2][1];
+            word_t* dst = &_wave[(t+1) % 2][1];
+            for(unsigned int i=t; i + t < rows + 2*n; ++i) {
+              const word_t* above = (t == 1 ? in[i-1] : src + (i-1)*stride);
+              const word_t* row = (t == 1 ? in[i] : src + i*stride);
+              const word_t* below = (t == 1 ? in[i+1] : src + (i+1)*stride);
+              if(t < n)
+                nextRow(above, row, below, tileWords, WORD_BITS - 1,
+                    dst + i*stride);
+              else
+                nextRow(above, row, below, tileWords, WORD_BITS - 1,
+                    _next->row(r0 + i - n) + lo + w0 - p, p, p + tw);
+            } // end for i
+          } // end for t
+        } // end for w0
+      } // end for r0
+      return;
+    } // end of method computeTemporal
+
+    /*
+     Calcola la generazione successiva a coppie di righe, 2x2 celle alla
+     volta con una tabella (ENGINE_LUT). Se le righe sono dispari l'ultima
+     coppia e' formata dalle ultime due righe, per cui la penultima viene
+     calcolata due volte.
+    */
+    void computeLut() {
+      const LifeTable& table = activeTable();
+      unsigned int words = _slice->getWords();
+      unsigned int lastBit = (_cols-1) % WORD_BITS;
+      for(unsigned int i=0; i < _rows; i += 2) {
+        if(i+1 == _rows) i = _rows-2;
+        nextRowPair(table, _slice->row(i-1), _slice->row(i), _slice->row(i+1),
+            _slice->row(i+2), words, lastBit, _next->row(i), _next->row(i+1));
+      } // end for i
+      return;
+    } // end of method computeLut
+
+    /*
+     Calcola la generazione successiva con il kernel bit a bit, solo nelle
+     tessere in cui potrebbe essere diversa da quella che si trova gia' in
+     _next (ENGINE_TILED). Ogni tessera ricorda se e' cambiata rispetto alla
+     generazione precedente (CHANGED_1) e a quella di due generazioni prima
+     (CHANGED_2); per le tessere sul bordo sinistro e destro contano anche i
+     cambiamenti delle colonne fantasma, e le righe di tessere si chiudono in
+     modo toroidale come le righe di celle. Una tessera non viene ricalcolata
+     se in essa e nelle 8 tessere vicine:
+     - nessuna cella e' cambiata (periodo 1): la generazione successiva e'
+       uguale alla corrente, e quindi alla precedente che si trova in _next;
+     - ogni cella e' uguale a due generazioni prima (periodo 2): la
+       generazione successiva e' uguale alla precedente, gia' in _next.
+     In entrambi i casi la tessera e' congelata senza copie, finche' un
+     cambiamento nelle vicine non la risveglia.
+    */
+    void computeTiled() {
+      unsigned int words = _slice->getWords();
+      unsigned int lastBit = (_cols-1) % WORD_BITS;
+      int tileCols = _tileCols;
+      for(unsigned int tr=0; tr < _tileRows; ++tr)
+        for(int tc=0; tc < tileCols; ++tc) {
+          unsigned char changed = 0;
+          for(int dr=-1; dr <= 1; ++dr) {
+            unsigned int r = (tr + _tileRows + dr) % _tileRows;
+            for(int c=tc-1; c <= tc+1; ++c) {
+              if(c < 0) changed |= _halo[r];
+              else if(c == tileCols) changed |= _halo[_tileRows + r];
+              else changed |= _changed[r*_tileCols + c];
+            } // end for c
+          } // end for dr
+          bool frozen = (_tracked >= 1 && !(changed & CHANGED_1)) ||
+              (_tracked >= 2 && !(changed & CHANGED_2));
+          _active[tr*_tileCols + tc] = !frozen;
+        } // end for tc
+      // Differenze di ogni parola dalla generazione corrente e da quella
+      // precedente, accumulate sulle righe di una riga di tessere
+      word_t* diff1 = &_scratch[0];
+      word_t* diff2 = diff1 + words;
+      for(unsigned int tr=0; tr < _tileRows; ++tr) {
+        const unsigned char* active = &_active[tr*_tileCols];
+        unsigned char* changed = &_changed[tr*_tileCols];
+        memset(diff1, 0, 2*sizeof(word_t)*words);
+        unsigned int i1 = (tr+1) * TILE_ROWS;
+        if(i1 > _rows) i1 = _rows;
+        for(unsigned int i=tr*TILE_ROWS; i < i1; ++i) {
+          // Le tessere attive consecutive di una riga sono calcolate insieme
+          for(unsigned int tc=0; tc < _tileCols; ) {
+            if(!active[tc]) { ++tc; continue; }
+            unsigned int end = tc;
+            while(end < _tileCols && active[end]) ++end;
+            unsigned int w1 = end * TILE_WORDS;
+            if(w1 > words) w1 = words;
+            nextRowTracked(_slice->row(i-1), _slice->row(i), _slice->row(i+1),
+                words, lastBit, _next->row(i), tc * TILE_WORDS, w1, diff1,
+                diff2);
+            tc = end;
+          } // end for tc
+        } // end for i
+        // Una tessera congelata con periodo 1 lo e' anche con periodo 2,
+        // mentre con periodo 2 resta diversa dalla precedente se lo era
+        for(unsigned int tc=0; tc < _tileCols; ++tc) {
+          if(!active[tc]) {
+            if(!(changed[tc] & CHANGED_1)) changed[tc] = 0;
+            continue;
+          }
+          word_t d1 = 0, d2 = 0;
+          for(unsigned int w=tc*TILE_WORDS; w < (tc+1)*TILE_WORDS &&
+              w < words; ++w) {
+            d1 |= diff1[w];
+            d2 |= diff2[w];
+          } // end for w
+          changed[tc] = (d1 ? CHANGED_1 : 0) | (d2 ? CHANGED_2 : 0);
+        } // end for tc
+      } // end for tr
+      _halo.assign(_halo.size(), 0);
+      if(_tracked < 2) _tracked++;
+      return;
+    } // end of method computeTiled
+
+    /*
+     Calcola la generazione successiva a partire dalle sole celle vive
+     (ENGINE_SPARSE). Anche _next viene aggiornata, spegnendo le celle vive
+     della generazione precedente e accendendo quelle nuove, con un costo
+     proporzionale alla popolazione: cosi' le colonne di bordo, i vettori e
+     la serializzazione funzionano come con gli altri motori.
+    */
+    void computeSparse() {
+      if(!_liveValid) _live.assign(*_slice);
+      if(!_prevValid) {
+        for(unsigned int i=0; i < _rows; ++i) _next->clearRow(i);
+        _livePrev.start.assign(_rows + 1, 0);
+        _livePrev.cols.clear();
+      }
+      for(unsigned int i=0; i < _rows; ++i)
+        for(unsigned int k=_livePrev.start[i]; k < _livePrev.start[i+1]; ++k)
+          setBit(_next->row(i), _livePrev.cols[k], false);
+      _counts.resize(_cols, 0);
+      nextLiveCells(*_slice, _live, _livePrev, _counts, _touched,
+          activeRule());
+      for(unsigned int i=0; i < _rows; ++i)
+        for(unsigned int k=_livePrev.start[i]; k < _livePrev.start[i+1]; ++k)
+          setBit(_next->row(i), _livePrev.cols[k], true);
+      std::swap(_live, _livePrev);
+      _liveValid = _prevValid = true;
+      return;
+    } // end of method computeSparse
+
+    /*
+     Calcola _stats confrontando _next con _slice, per i motori che non
+     le calcolano mentre scrivono la generazione successiva. Con
+     ENGINE_SPARSE confronta gli elenchi delle celle vive delle due
+     generazioni, altrimenti tutte le righe.
+    */
+    void collectStats(Engine engine) {
+      if(engine != ENGINE_SPARSE) {
+        for(unsigned int i=0; i < _rows; ++i)
+          _stats.addWords(i, _slice->row(i), _next->row(i), 0,
+              _slice->getWords(), _cols, _pos);
+        return;
+      }
+      for(unsigned int i=0; i < _rows; ++i) {
+        unsigned int k = _livePrev.start[i], kend = _livePrev.start[i+1];
+        unsigned int h = _live.start[i], hend = _live.start[i+1];
+        while(k < kend || h < hend) {
+          unsigned int was = (k < kend ? _livePrev.cols[k] : _cols);
+          unsigned int is = (h < hend ? _live.cols[h] : _cols);
+          unsigned int j = std::min(was, is);
+          _stats.addCell(i, _pos + j, was == j, is == j);
+          if(was == j) k++;
+          if(is == j) h++;
+        } // end while
+      } // end for i
+      return;
+    } // end of method collectStats
+
+    /*
+     Sceglie il motore per ENGINE_AUTO: ENGINE_SPARSE se la densita' della
+     popolazione e' inferiore a SPARSE_DENSITY, ENGINE_TILED altrimenti. Con
+     ENGINE_SPARSE la popolazione e' nota ad ogni generazione, con
+     ENGINE_TILED viene contata ogni AUTO_PERIOD generazioni; per non
+     alternare continuamente i motori si torna a ENGINE_SPARSE solo sotto
+     la meta' della soglia. Con le regole B0 (vedi sparseSupported) sceglie
+     sempre ENGINE_TILED.
+    */
+    Engine autoEngine() {
+      if(!sparseSupported(activeRule())) return ENGINE_TILED;
+      double area = double(_rows) * _cols;
+      if(_liveValid)
+        return (_live.size() > SPARSE_DENSITY * area ?
+            ENGINE_TILED : ENGINE_SPARSE);
+      if(_untilCheck > 0) {
+        _untilCheck--;
+        return ENGINE_TILED;
+      }
+      _untilCheck = AUTO_PERIOD - 1;
+      return (getPopulation() < SPARSE_DENSITY / 2 * area ?
+          ENGINE_SPARSE : ENGINE_TILED);
+    } // end of method autoEngine
+
+    /*
+     Copia nelle colonne a partire dalla j (anche fantasma) gli elementi del
+     vettore v, una colonna ogni columnBits() elementi. Se una colonna e'
+     fantasma,
+     segna le righe di tessere in cui e' cambiata rispetto alla generazione
+     precedente (che si trova in _next) e a quella di due generazioni prima
+     (che viene sovrascritta).
+    */
+    void setColumns(int j, const Vector& v) {
+      unsigned int n = v.getVectorSize() / columnBits();
+      for(unsigned int c=0; c < n; ++c, ++j) {
+        unsigned char* halo = (j < 0 ? &_halo[0] : &_halo[_tileRows]);
+        bool ghost = (j < 0 || j >= (int)_cols);
+        for(unsigned int i=0; i < _rows; ++i) {
+          bool value = v.get(c*columnBits() + i);
+          if(ghost) {
+            if(value != _next->get(i,j)) halo[i / TILE_ROWS] |= CHANGED_1;
+            if(value != _slice->get(i,j)) halo[i / TILE_ROWS] |= CHANGED_2;
+          }
+          _slice->set(i, j, value);
+          if(value && _boxValid)
+            _box.add(i, j < 0 ? -(int)((WORD_BITS - 1 - j) / WORD_BITS) :
+                j / WORD_BITS);
+        } // end for i
+      } // end for c
+      return;
+    } // end of method setColumns
+
+    /*
+     Restituisce la somma dei contributi (vedi hashWord) delle parole da
+     begin a end-1 della riga i di s, ignorando le colonne fantasma.
+    */
+    uint64_t hashWords(const Slice& s, unsigned int i, int begin,
+        int end) const {
+      unsigned int words = s.getWords();
+      begin = std::max(begin, 0);
+      end = std::min(end, (int)words);
+      const word_t* row = s.row(i);
+      uint64_t base = (uint64_t(_n) * _rows + i) * words;
+      uint64_t hash = 0;
+      for(int w=begin; w < end; ++w) {
+        word_t bits = row[w];
+        if(w + 1 == (int)words) bits &= lowMask((_cols-1) % WORD_BITS + 1);
+        hash += hashWord(bits, base + w);
+      } // end for w
+      return hash;
+    } // end of method hashWords
+
+    /*
+     Copia in _boundary i bordi di _slice.
+    */
+    void fillBoundary() {
+      for(unsigned int i=0; i < _rows; ++i)
+        copyBoundary(*_slice, i, true, true);
+      _boundaryValid = true;
+      return;
+    } // end of method fillBoundary
+
+    /*
+     Restituisce un nuovo vettore con gli elementi delle n colonne a partire
+     dalla j (anche fantasma), una colonna ogni columnBits() elementi.
+    */
+    Vector* getColumns(int j, unsigned int n) const {
+      Vector* v = new Vector(n * columnBits());
+      for(unsigned int c=0; c < n; ++c, ++j)
+        for(unsigned int i=0; i < _rows; ++i)
+          v->set(c*columnBits() + i, _slice->get(i,j));
+      return v;
+    } // end of method getColumns
+
   // PUBLIC METHODS
   public:
-    
+
     /**
      * Costruttore di default: costruisce un blocco vuoto.
      */
-    Block() : _n(0), _pos(0), _rows(0), _cols(0) { }
-    
+    Block() : _n(0), _pos(0), _rows(0), _cols(0), _depth(1), _step(0),
+        _slice(NULL), _next(NULL),
+        _engine(ENGINE_BITWISE), _threads(1), _strip(0), _temporal(false),
+        _statsEnabled(false), _boundaryValid(false), _boxValid(false),
+        _nextBoxValid(false), _hashEnabled(false), _hashValid(false),
+        _allocations(0),
+        _tileRows(0), _tileCols(0), _tracked(0), _liveValid(false),
+        _prevValid(false), _untilCheck(0) { }
+
     /**
      * Costruisce un blocco a partire dalla matrice "matrix". Il blocco
      * costruito ha come numero "n", dimensione "dim" (numero di colonne) e
-     * viene costruito a partire dalla colonna "pos" della matrice.
+     * viene costruito a partire dalla colonna "pos" della matrice, con
+     * "depth" colonne fantasma per lato.
      */
-    Block(unsigned int n, unsigned int dim, unsigned int pos, 
-        bool** matrix, unsigned int rows, unsigned int cols) : 
-        _n(n), _pos(pos), _rows(rows), _cols(dim) {
-      _slice = new bool*[_rows];
-      _leftv = new Vector(_rows);
-      _rightv = new Vector(_rows);
-      unsigned int jleft = (pos == 0 ? cols-1 : pos-1);
-      unsigned int jright = (pos+dim == cols ? 0 : pos+dim);
+    Block(unsigned int n, unsigned int dim, unsigned int pos,
+        const word_t* const* matrix, unsigned int rows, unsigned int cols,
+        unsigned int depth = 1) :
+        _n(n), _pos(pos), _rows(rows), _cols(dim), _depth(depth), _step(0),
+        _engine(ENGINE_BITWISE), _threads(1), _strip(0), _temporal(false),
+        _statsEnabled(false), _boxValid(false), _nextBoxValid(false),
+        _hashEnabled(false), _hashValid(false), _allocations(0) {
+      _slice = newSlice();
+      _next = newSlice();
+      resetTiles();
+      resetBoundary();
       for(unsigned int i=0; i < _rows; ++i) {
-        _leftv->set(i,matrix[i][jleft]);
-        _rightv->set(i,matrix[i][jright]);
-        _slice[i] = new bool[dim];
-        for(unsigned int j=0; j < dim; ++j)
-          _slice[i][j] = matrix[i][pos+j];
+        for(unsigned int c=1; c <= _depth; ++c) {
+          unsigned int jleft = (pos + cols*_depth - c) % cols;
+          unsigned int jright = (pos + dim + c - 1) % cols;
+          _slice->set(i, -(int)c, getBit(matrix[i], jleft));
+          _slice->set(i, _cols + c - 1, getBit(matrix[i], jright));
+        } // end for c
+        copyBits(_slice->row(i), 0, matrix[i], pos, dim);
       } // end for i
       return;
     } // end of constructor
-    
+
     /**
      * Distruttore
      */
     virtual ~Block() {
-      deleteSlice();
-      delete _leftv;
-      delete _rightv;
+      delete _slice;
+      delete _next;
     } // end of distructor
-    
+
+    /**
+     * Imposta il motore utilizzato per calcolare le generazioni successive.
+     */
+    void setEngine(Engine engine) {
+      _engine = engine;
+      _tracked = 0;
+      _untilCheck = 0;
+    } // end of method setEngine
+
+    /**
+     * Imposta la larghezza in parole delle strisce di colonne in cui
+     * ENGINE_BITWISE percorre il blocco (0 per percorrerlo a righe intere).
+     */
+    void setStrip(unsigned int words) {
+      _strip = words;
+    } // end of method setStrip
+
+    /**
+     * Imposta il numero di thread con cui ENGINE_BITWISE calcola le
+     * generazioni, ognuno una fascia di righe (vedi bandRows). Le matrici
+     * del blocco vengono riallocate e copiate dagli stessi thread, cosi'
+     * che le pagine di ogni fascia si trovino vicino al thread che la
+     * calcola (e vengono posizionate con la politica restituita da
+     * activeNumaPolicy). Con relocate le matrici vengono riallocate anche se
+     * il numero di thread non cambia, ad esempio dopo aver fissato i thread
+     * alle CPU.
+     */
+    void setThreads(unsigned int threads, bool relocate = false) {
+      if(threads == _threads && !relocate) return;
+      _threads = threads;
+      Slice* slice = newSlice();
+      Slice* next = newSlice();
+      slice->copyFrom(*_slice, _threads);
+      next->copyFrom(*_next, _threads);
+      delete _slice;
+      delete _next;
+      _slice = slice;
+      _next = next;
+      return;
+    } // end of method setThreads
+
+    /**
+     * Abilita o disabilita la tassellazione temporale di advance.
+     */
+    void setTemporal(bool temporal) {
+      _temporal = temporal;
+    } // end of method setTemporal
+
+    /**
+     * Abilita o disabilita il calcolo delle statistiche di ogni generazione
+     * (vedi getStats). Con ENGINE_BITWISE vengono calcolate riga per riga
+     * insieme alla generazione, senza percorrere di nuovo il blocco. Le
+     * generazioni calcolate da advance con la tassellazione temporale non
+     * hanno statistiche.
+     */
+    void setStats(bool enabled) {
+      _statsEnabled = enabled;
+    } // end of method setStats
+
+    /**
+     * Abilita o disabilita il calcolo dell'hash del blocco (vedi getHash)
+     * insieme alla generazione che precede una sincronizzazione, con
+     * ENGINE_BITWISE.
+     */
+    void setHashing(bool enabled) {
+      _hashEnabled = enabled;
+    } // end of method setHashing
+
+    /**
+     * Restituisce l'hash delle celle del blocco, che dipende anche dal
+     * numero del blocco: la somma degli hash dei blocchi di una matrice e'
+     * l'hash della matrice (vedi hashWord). Se e' stato abilitato con
+     * setHashing e il blocco e' appena stato calcolato con ENGINE_BITWISE
+     * l'hash e' gia' noto, altrimenti viene calcolato percorrendo il blocco.
+     */
+    uint64_t getHash() {
+      if(!_hashValid) {
+        _hash = 0;
+        for(unsigned int i=0; i < _rows; ++i)
+          _hash += hashWords(*_slice, i, 0, _slice->getWords());
+        _hashValid = true;
+      }
+      return _hash;
+    } // end of method getHash
+
+    /**
+     * Restituisce le statistiche dell'ultima generazione calcolata da
+     * compute, con le colonne riferite alla matrice (vedi setStats).
+     */
+    const Stats& getStats() const {
+      return _stats;
+    } // end of method getStats
+
+    /**
+     * Restituisce il motore utilizzato per calcolare le generazioni
+     * successive.
+     */
+    Engine getEngine() const {
+      return _engine;
+    } // end of method getEngine
+
+    /**
+     * Restituisce il numero di matrici di celle allocate dal blocco dalla sua
+     * costruzione. Dopo la costruzione il valore non cambia piu': compute
+     * alterna due matrici allocate una sola volta.
+     */
+    unsigned long getAllocations() const {
+      return _allocations;
+    } // end of method getAllocations
+
     /**
      * Restituisce il numero del blocco (n).
      */
     unsigned int getN() const {
       return _n;
     } // end of method get
-    
+
     /**
      * Restituisce la posizione del blocco nella matrice.
      */
     unsigned int getPosition() const {
       return _pos;
     } // end of method get
-    
+
     /**
      * Restituisce il numero di righe del blocco.
      */
@@ -162,99 +993,202 @@ class Block : public MSL_Serializable {
     unsigned int getColumns() const {
       return _cols;
     } // end of method getColumns();
-    
+
     /**
-     * Restituisce l'elemento nella riga i - colonna j.
+     * Restituisce l'elemento nella riga i - colonna j. La colonna -1 e la
+     * colonna getColumns() sono rispettivamente il vettore sinistro e il
+     * vettore destro.
      */
-    bool& get(unsigned int i, unsigned int j) {
-      return _slice[i][j];
+    bool get(unsigned int i, int j) const {
+      return _slice->get(i,j);
     } // end of method get
-    
+
     /**
-     * Restituisce l'elemento nella riga i - colonna j.
+     * Imposta l'elemento nella riga i - colonna j.
      */
-    const bool& get(unsigned int i, unsigned int j) const {
-      return _slice[i][j];
-    } // end of method get
-    
+    void set(unsigned int i, unsigned int j, bool value) {
+      _slice->set(i, j, value);
+      _tracked = 0;
+      _boundaryValid = false;
+      _boxValid = _hashValid = false;
+      _liveValid = false;
+      return;
+    } // end of method set
+
     /**
-     * Restituisce un puntatore ad un nuovo oggetto di tipo Vector che contiene
-     * una copia degli elementi della prima colonna del blocco (il suo bordo 
-     * sinistro).
+     * Restituisce il numero di celle vive del blocco.
      */
-    Vector* getLeftBoundary() const {
-      Vector* leftb = new Vector(_rows);
-      for(int i=0; i < _rows; ++i)
-        leftb->set(i, _slice[i][0]);
-      return leftb;
-    } // end of method getLeftBoundary
-    
+    unsigned long getPopulation() const {
+      unsigned int words = _slice->getWords();
+      word_t last = lowMask((_cols-1) % WORD_BITS + 1);
+      unsigned long population = 0;
+      for(unsigned int i=0; i < _rows; ++i) {
+        const word_t* row = _slice->row(i);
+        for(unsigned int w=0; w+1 < words; ++w)
+          population += __builtin_popcountll(row[w]);
+        population += __builtin_popcountll(row[words-1] & last);
+      } // end for i
+      return population;
+    } // end of method getPopulation
+
     /**
-     * Restituisce un puntatore ad un nuovo oggetto di tipo Vector che contiene
-     * una copia degli elementi dell'ultima colonna del blocco (il suo bordo 
-     * destro).
+     * Restituisce la riga i del blocco in forma compatta (un bit per cella).
      */
-    Vector* getRightBoundary() const {
-      Vector* rightb = new Vector(_rows);
-      for(int i=0; i < _rows; ++i)
-        rightb->set(i, _slice[i][_cols-1]);
-      return rightb;
-    } // end of method getRightBoundary
-    
+    const word_t* getRow(unsigned int i) const {
+      return _slice->row(i);
+    } // end of method getRow
+
+    /**
+     * Restituisce il numero di colonne fantasma per lato.
+     */
+    unsigned int getDepth() const {
+      return _depth;
+    } // end of method getDepth
+
+    /**
+     * Restituisce il numero di generazioni che il blocco puo' calcolare tra
+     * due sincronizzazioni: getDepth(), o getDepth()/r con una regola Larger
+     * than Life di raggio r.
+     */
+    unsigned int getPeriod() const {
+      unsigned int radius = activeLtlRule().radius;
+      return (radius == 0 ? _depth : _depth / radius);
+    } // end of method getPeriod
+
+    /**
+     * Restituisce true se il blocco ha bisogno di nuovi vettori prima di
+     * calcolare la prossima generazione, cioe' ogni getPeriod() generazioni.
+     */
+    bool needsSynch() const {
+      return _step == 0;
+    } // end of method needsSynch
+
     /**
-     * Restituisce il vettore sinistro.
+     * Restituisce il numero di generazioni che il blocco puo' ancora
+     * calcolare prima di aver bisogno di nuovi vettori.
      */
-    const Vector& getLeftVector() const {
-      return (*_leftv);
-    } // end of method getLeftVector
-    
+    unsigned int getStepsToSynch() const {
+      return getPeriod() - _step;
+    } // end of method getStepsToSynch
+
     /**
-     * Restituisce il vettore destro.
+     * Restituisce il vettore del blocco che contiene una copia degli elementi
+     * delle prime getDepth() colonne (il suo bordo sinistro), una colonna
+     * dopo l'altra. Il vettore viene riutilizzato ad ogni sincronizzazione:
+     * con ENGINE_BITWISE e' gia' stato scritto da compute, con gli altri
+     * motori viene copiato dal blocco alla prima richiesta.
      */
-    const Vector& getRightVector() const {
-      return (*_rightv);
-    } // end of method getRightVector
-    
+    Vector& getLeftBoundary() {
+      if(!_boundaryValid) fillBoundary();
+      return _boundary[0];
+    } // end of method getLeftBoundary
+
     /**
-     * Cambia il vettore sinistro con quello passato come parametro.
+     * Restituisce il vettore del blocco che contiene una copia degli elementi
+     * delle ultime getDepth() colonne (il suo bordo destro), una colonna
+     * dopo l'altra (vedi getLeftBoundary).
      */
-    void setLeftVector(Vector* leftv) {
-      delete _leftv;
-      _leftv = leftv;
+    Vector& getRightBoundary() {
+      if(!_boundaryValid) fillBoundary();
+      return _boundary[1];
+    } // end of method getRightBoundary
+
+    /**
+     * Scrive il vettore sinistro, passato come parametro, nelle colonne
+     * fantasma di sinistra.
+     */
+    void setLeftVector(const Vector& leftv) {
+      setColumns(-(int)_depth, leftv);
     } // end of method setLeftVector
-    
+
     /**
-     * Cambia il vettore destro con quello passato come parametro.
+     * Scrive il vettore destro, passato come parametro, nelle colonne
+     * fantasma di destra.
      */
-    void setRightVector(Vector* rightv) {
-      delete _rightv;
-      _rightv = rightv;
+    void setRightVector(const Vector& rightv) {
+      setColumns(_cols, rightv);
     } // end of method setRightVector
-    
+
     /**
-     * Esegue un'iterazione del gioco della vita sugli elementi del blocco.
+     * Esegue un'iterazione del gioco della vita sugli elementi del blocco,
+     * utilizzando il motore impostato con setEngine. La generazione
+     * successiva viene scritta nella seconda matrice del blocco, che poi
+     * viene scambiata con quella corrente. Con getDepth() > 1 il motore deve
+     * essere ENGINE_BITWISE. Con una regola Larger than Life il motore non
+     * viene utilizzato.
      */
     void compute() {
-      bool** newslice = new bool*[_rows];
-      for(int i=0; i < _rows; ++i) {
-        newslice[i] = new bool[_cols];
-        for(int j=0; j < _cols; ++j)
-          newslice[i][j] = getNextValue(i,j);
-      } // end for i
-      deleteSlice();
-      _slice = newslice;
+      // Con una regola Larger than Life le tessere e le celle vive non
+      // vengono aggiornate, come con ENGINE_BITWISE
+      bool ltl = (activeLtlRule().radius > 0);
+      Engine engine = (ltl ? ENGINE_BITWISE :
+          _engine == ENGINE_AUTO ? autoEngine() : _engine);
+      _stats.clear();
+      bool bitwise = (!ltl && engine == ENGINE_BITWISE);
+      _boundaryValid = (bitwise && _step + 1 == _depth);
+      _hashValid = (_boundaryValid && _hashEnabled);
+      if(ltl) computeLtl();
+      else if(engine == ENGINE_SPLIT) computeSplit();
+      else if(engine == ENGINE_SPARSE) computeSparse();
+      else {
+        _slice->wrapRows();
+        if(engine == ENGINE_LUT) computeLut();
+        else if(engine == ENGINE_TILED) computeTiled();
+        else if(engine == ENGINE_SCALAR)
+          for(int i=0; i < _rows; ++i) computeRowScalar(i);
+        else computeBitwise();
+      }
+      if(_statsEnabled && !bitwise)
+        collectStats(engine);
+      if(engine != ENGINE_TILED) _tracked = 0;
+      if(engine != ENGINE_SPARSE) _liveValid = _prevValid = false;
+      if(bitwise) {
+        std::swap(_box, _nextBox);
+        std::swap(_boxValid, _nextBoxValid);
+      }
+      else _boxValid = _nextBoxValid = false;
+      _step = (_step + 1) % getPeriod();
+      Slice* tmp = _slice;
+      _slice = _next;
+      _next = tmp;
       return;
     } // end of method compute
 
+    /**
+     * Esegue n iterazioni del gioco della vita, con n al massimo pari a
+     * getStepsToSynch(). Con ENGINE_BITWISE e la tassellazione temporale
+     * abilitata (vedi setTemporal) le n generazioni vengono calcolate una
+     * tessera alla volta, altrimenti equivale a chiamare n volte compute.
+     */
+    void advance(unsigned int n) {
+      if(!_temporal || _engine != ENGINE_BITWISE || n < 2 ||
+          activeLtlRule().radius > 0) {
+        for(unsigned int t=0; t < n; ++t) compute();
+        return;
+      }
+      computeTemporal(n);
+      _tracked = 0;
+      _boundaryValid = false;
+      _boxValid = _nextBoxValid = _hashValid = false;
+      _liveValid = _prevValid = false;
+      _step = (_step + n) % getPeriod();
+      Slice* tmp = _slice;
+      _slice = _next;
+      _next = tmp;
+      return;
+    } // end of method advance
+
     /** Override */
     virtual inline int getSize() {
       return sizeof(unsigned int) +  // _n
           sizeof(unsigned int) +     // _pos
           sizeof(unsigned int) +     // _rows
           sizeof(unsigned int) +     // _cols
-          sizeof(bool)*_rows*_cols + // _slice
-          _leftv->getSize() +        // _leftv
-          _rightv->getSize();        // _rightv          
+          sizeof(unsigned int) +     // _depth
+          sizeof(word_t)*_rows*_slice->getWords() + // _slice
+          2 * (sizeof(unsigned int) + // colonne fantasma (come Vector, al
+                                      // massimo)
+              sizeof(word_t)*_depth*wordsFor(_rows));
     } // end of method getSize
 
     /** Override */
@@ -268,17 +1202,24 @@ class Block : public MSL_Serializable {
       adr1++;
       memcpy(adr1, &(_cols), sizeof(uint));
       adr1++;
-      bool* adr2 = (bool*) adr1;
+      memcpy(adr1, &(_depth), sizeof(uint));
+      adr1++;
+      word_t* adr2 = (word_t*) adr1;
+      unsigned int words = _slice->getWords();
       for(int i = 0; i < _rows; ++i) {
-        memcpy(adr2, _slice[i], sizeof(bool)*_cols);
-        adr2 += _cols;
+        memcpy(adr2, _slice->row(i), sizeof(word_t)*words);
+        adr2 += words;
       }
-      _leftv->reduce((void*)adr2, bufferSize);
-      unsigned char* adr3 = ((unsigned char*)adr2 + _leftv->getSize());
-      _rightv->reduce((void*)adr3, bufferSize);
+      Vector* leftv = getColumns(-(int)_depth, _depth);
+      Vector* rightv = getColumns(_cols, _depth);
+      leftv->reduce((void*)adr2, bufferSize);
+      unsigned char* adr3 = ((unsigned char*)adr2 + leftv->getSize());
+      rightv->reduce((void*)adr3, bufferSize);
+      delete leftv;
+      delete rightv;
       return;
     } // end of method reduce
-    
+
     /** Override */
     virtual void expand(void* pBuffer, int bufferSize) {
       unsigned int* adr1 = (unsigned int*) pBuffer;
@@ -286,18 +1227,27 @@ class Block : public MSL_Serializable {
       _pos = *(adr1++);
       _rows = *(adr1++);
       _cols = *(adr1++);
-      bool* adr2 = (bool*) adr1;
-      _slice = new bool*[_rows];
+      _depth = *(adr1++);
+      _step = 0;
+      _boxValid = _nextBoxValid = _hashValid = false;
+      delete _slice;
+      delete _next;
+      _slice = newSlice();
+      _next = newSlice();
+      resetTiles();
+      resetBoundary();
+      word_t* adr2 = (word_t*) adr1;
+      unsigned int words = _slice->getWords();
       for(int i=0; i < _rows; ++i) {
-        _slice[i] = new bool[_cols];
-        for(int j=0; j < _cols; ++j)
-          _slice[i][j] = *(adr2++);
+        memcpy(_slice->row(i), adr2, sizeof(word_t)*words);
+        adr2 += words;
       }
-      _leftv = new Vector();
-      _leftv->expand((void*)adr2, bufferSize);
-      unsigned char* adr3 = ((unsigned char*)adr2 + _leftv->getSize());
-      _rightv = new Vector();
-      _rightv->expand((void*)adr3, bufferSize);
+      Vector leftv, rightv;
+      leftv.expand((void*)adr2, bufferSize);
+      unsigned char* adr3 = ((unsigned char*)adr2 + leftv.getSize());
+      rightv.expand((void*)adr3, bufferSize);
+      setLeftVector(leftv);
+      setRightVector(rightv);
       return;
     } // end of method expand
 
@@ -309,11 +1259,12 @@ class Block : public MSL_Serializable {
  * alle celle del blocco.
  */
 std::ostream& operator<<(std::ostream& out, const Block& b) {
+  int cols = b.getColumns();
   for(unsigned int i = 0; i < b.getRows(); ++i) {
-    out <<(b.getLeftVector().get(i) ? "[*] " : "[ ] ");
-    for(unsigned int j = 0; j < b.getColumns(); ++j)
+    out <<(b.get(i,-1) ? "[*] " : "[ ] ");
+    for(int j = 0; j < cols; ++j)
       out <<(b.get(i,j) ? "[*]" : "[ ]");
-    out <<(b.getRightVector().get(i) ? " [*]" : " [ ]") <<std::endl;
+    out <<(b.get(i,cols) ? " [*]" : " [ ]") <<std::endl;
   }
   return out;
 } // end of function operator<<
@@ -322,4 +1273,3 @@ std::ostream& operator<<(std::ostream& out, const Block& b) {
 
 
 #endif // _BLOCK_H
-
@@ -0,0 +1,487 @@
+/*!
+  \file HashLife.h
+  \brief Implementazione della classe gameoflife::HashLife
+  \date 18-10-2026
+*/
+
+#ifndef _HASHLIFE_H
+#define _HASHLIFE_H 1
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <stdint.h>
+#include <unordered_map>
+#include "Kernel.h"
+#include "Matrix.h"
+
+
+namespace gameoflife {
+
+/*!
+  \struct Node
+  \brief Nodo del quadtree di HashLife.
+
+  Un nodo di livello l rappresenta un quadrato di 2^l x 2^l celle, diviso
+  nei quattro quadranti nw, ne, sw, se di livello l-1; i nodi di livello 0
+  sono le celle. I nodi sono unici (hash-consing): due nodi con le stesse
+  celle sono lo stesso nodo, per cui si confrontano con i puntatori.
+*/
+struct Node {
+  Node* nw;
+  Node* ne;
+  Node* sw;
+  Node* se;
+  Node* next;     // nodo successivo nella lista della tabella hash (o dei
+                  // nodi liberi)
+  Node* full;     // risultato dopo 2^(level-2) generazioni
+  Node* partial;  // risultato dopo 2^partialStep generazioni
+  unsigned char level;
+  unsigned char partialStep;
+  bool marked;    // raggiungibile (garbage collection)
+}; // end of struct Node
+
+//! Livello che indica un nodo libero.
+const unsigned char FREE_NODE = 0xff;
+
+//! Memoria massima di default dei nodi di HashLife, in megabyte.
+const unsigned long HASHLIFE_MEMORY = 256;
+
+/*!
+  \class HashLife
+  \brief Calcola una generazione qualsiasi di una matrice con HashLife.
+
+  L'algoritmo di Gosper memorizza la matrice in un quadtree di nodi unici e,
+  per ogni nodo di livello l, ricorda il risultato: il quadrato centrale di
+  livello l-1 dopo 2^j generazioni (j <= l-2). Le regioni che si ripetono,
+  nello spazio o nel tempo, vengono calcolate una volta sola, e una
+  generazione lontana si ottiene con O(log) passi di ampiezza crescente.
+
+  La matrice e' un toro: il quadtree contiene la sua ripetizione periodica,
+  di cui il risultato di un nodo abbastanza grande coincide con il toro
+  dopo 2^j generazioni. Se le dimensioni della matrice sono potenze di 2 la
+  ripetizione e' allineata ai nodi, e i nodi di ogni livello sono costruiti
+  accostando quattro copie di quelli del livello precedente: un passo di
+  2^j generazioni costa O(j) nodi nuovi piu' il calcolo dei risultati
+  ancora sconosciuti. Altrimenti la matrice viene campionata ad ogni passo
+  in un nodo di lato almeno doppio, e avanza di meta' del lato per volta;
+  gli stati gia' visti vengono riconosciuti (i nodi sono unici) e il ciclo
+  viene saltato.
+
+  Quando i nodi superano la memoria massima, tra un passo e il successivo
+  vengono eliminati quelli non raggiungibili dallo stato corrente, e i
+  risultati che vi puntano vengono dimenticati.
+*/
+class HashLife {
+
+  // PRIVATE MEMBERS
+  private:
+
+    size_t _maxNodes;              // nodi oltre i quali si libera memoria
+    size_t _nodes;                 // nodi in uso
+    size_t _peakNodes;             // massimo numero di nodi in uso
+    unsigned long _collections;    // numero di garbage collection
+    std::vector<Node*> _table;     // tabella hash dei nodi (liste)
+    std::vector<Node*> _chunks;    // blocchi di nodi allocati
+    Node* _free;                   // lista dei nodi liberi
+    Node _cells[2];                // le celle morta e viva (livello 0)
+    std::vector<Node*> _empty;     // _empty[l]: nodo di livello l vuoto
+
+    // La copia non e' consentita
+    HashLife(const HashLife&);
+    HashLife& operator=(const HashLife&);
+
+  // PRIVATE METHODS
+  private:
+
+    /*
+      Numero di nodi di un blocco allocato
+    */
+    static size_t chunkNodes() {
+      return 1 << 16;
+    } // end of method chunkNodes
+
+    /*
+      Posizione nella tabella hash del nodo con i quadranti indicati
+    */
+    size_t hash(const Node* nw, const Node* ne, const Node* sw,
+        const Node* se) const {
+      uint64_t h = uint64_t(uintptr_t(nw)) * 0x9e3779b97f4a7c15ull +
+          uint64_t(uintptr_t(ne)) * 0xc2b2ae3d27d4eb4full +
+          uint64_t(uintptr_t(sw)) * 0x165667b19e3779f9ull +
+          uint64_t(uintptr_t(se)) * 0x27d4eb2f165667c5ull;
+      return (h ^ (h >> 29)) & (_table.size() - 1);
+    } // end of method hash
+
+    /*
+      Raddoppia la tabella hash quando contiene piu' nodi che liste
+    */
+    void growTable() {
+      std::vector<Node*> old(2 * _table.size(), (Node*) NULL);
+      old.swap(_table);
+      for(size_t b=0; b < old.size(); ++b)
+        for(Node* n = old[b]; n != NULL; ) {
+          Node* next = n->next;
+          size_t h = hash(n->nw, n->ne, n->sw, n->se);
+          n->next = _table[h];
+          _table[h] = n;
+          n = next;
+        } // end for n
+      return;
+    } // end of method growTable
+
+    /*
+      Restituisce un nodo libero, allocando un nuovo blocco se necessario
+    */
+    Node* newNode() {
+      if(_free == NULL) {
+        Node* chunk = new Node[chunkNodes()];
+        _chunks.push_back(chunk);
+        for(size_t k=0; k < chunkNodes(); ++k) {
+          chunk[k].level = FREE_NODE;
+          chunk[k].next = _free;
+          _free = &chunk[k];
+        } // end for k
+      }
+      Node* n = _free;
+      _free = n->next;
+      if(++_nodes > _peakNodes) _peakNodes = _nodes;
+      return n;
+    } // end of method newNode
+
+    /*
+      Restituisce l'unico nodo con i quadranti indicati
+    */
+    Node* join(Node* nw, Node* ne, Node* sw, Node* se) {
+      size_t h = hash(nw, ne, sw, se);
+      for(Node* n = _table[h]; n != NULL; n = n->next)
+        if(n->nw == nw && n->ne == ne && n->sw == sw && n->se == se)
+          return n;
+      Node* n = newNode();
+      n->nw = nw;
+      n->ne = ne;
+      n->sw = sw;
+      n->se = se;
+      n->full = n->partial = NULL;
+      n->level = nw->level + 1;
+      n->partialStep = 0;
+      n->marked = false;
+      n->next = _table[h];
+      _table[h] = n;
+      if(_nodes > _table.size()) growTable();
+      return n;
+    } // end of method join
+
+    /*
+      Restituisce la cella (nodo di livello 0) viva o morta
+    */
+    Node* cell(bool alive) {
+      return &_cells[alive ? 1 : 0];
+    } // end of method cell
+
+    /*
+      Restituisce il nodo vuoto di livello l
+    */
+    Node* empty(unsigned int l) {
+      while(_empty.size() <= l) {
+        Node* e = _empty.back();
+        _empty.push_back(join(e, e, e, e));
+      }
+      return _empty[l];
+    } // end of method empty
+
+    /*
+      Restituisce il quadrato centrale (di livello l-1) del nodo n
+    */
+    Node* centre(Node* n) {
+      return join(n->nw->se, n->ne->sw, n->sw->ne, n->se->nw);
+    } // end of method centre
+
+    /*
+      Restituisce il risultato di un nodo di livello 2: le 2x2 celle
+      centrali dopo una generazione, calcolate con la tabella della regola in
+      uso (activeTable)
+    */
+    Node* baseResult(Node* n) {
+      Node* q[4] = { n->nw, n->ne, n->sw, n->se };
+      unsigned int x = 0;
+      for(unsigned int k=0; k < 4; ++k) {
+        // Quadrante k: righe 2(k/2) e 2(k/2)+1, colonne 2(k%2) e 2(k%2)+1
+        unsigned int pos = 8*(k/2) + 2*(k%2);
+        x |= (q[k]->nw == cell(true)) << pos;
+        x |= (q[k]->ne == cell(true)) << (pos + 1);
+        x |= (q[k]->sw == cell(true)) << (pos + 4);
+        x |= (q[k]->se == cell(true)) << (pos + 5);
+      } // end for k
+      unsigned int r = activeTable().next[x];
+      return join(cell(r & 1), cell(r & 2), cell(r & 4), cell(r & 8));
+    } // end of method baseResult
+
+    /*
+      Restituisce il quadrato centrale (di livello l-1) del nodo n di
+      livello l dopo 2^j generazioni, con j <= l-2
+    */
+    Node* result(Node* n, unsigned int j) {
+      unsigned int l = n->level;
+      bool full = (j == l - 2);
+      if(full && n->full != NULL) return n->full;
+      if(!full && n->partial != NULL && n->partialStep == j)
+        return n->partial;
+      Node* r;
+      if(l == 2) r = baseResult(n);
+      else {
+        // I nove quadrati di livello l-1 che si sovrappongono in n
+        Node* s[9] = {
+          n->nw, join(n->nw->ne, n->ne->nw, n->nw->se, n->ne->sw), n->ne,
+          join(n->nw->sw, n->nw->se, n->sw->nw, n->sw->ne), centre(n),
+          join(n->ne->sw, n->ne->se, n->se->nw, n->se->ne),
+          n->sw, join(n->sw->ne, n->se->nw, n->sw->se, n->se->sw), n->se
+        };
+        // Con il passo massimo i quadrati avanzano di 2^(l-3) generazioni
+        // due volte, altrimenti solo la seconda
+        for(unsigned int k=0; k < 9; ++k)
+          s[k] = (full ? result(s[k], l - 3) : centre(s[k]));
+        unsigned int step = (full ? l - 3 : j);
+        r = join(result(join(s[0], s[1], s[3], s[4]), step),
+                 result(join(s[1], s[2], s[4], s[5]), step),
+                 result(join(s[3], s[4], s[6], s[7]), step),
+                 result(join(s[4], s[5], s[7], s[8]), step));
+      }
+      if(full) n->full = r;
+      else {
+        n->partial = r;
+        n->partialStep = j;
+      }
+      return r;
+    } // end of method result
+
+    /*
+      Costruisce il nodo di livello l con le celle della ripetizione
+      periodica della matrice m a partire dalla riga y e dalla colonna x
+      (ridotte modulo le dimensioni della matrice)
+    */
+    Node* sample(const Matrix& m, unsigned int l, uint64_t y, uint64_t x) {
+      if(l == 0) return cell(m.get(y % m.getRows(), x % m.getColumns()));
+      uint64_t h = uint64_t(1) << (l - 1);
+      return join(sample(m, l-1, y, x), sample(m, l-1, y, x + h),
+                  sample(m, l-1, y + h, x), sample(m, l-1, y + h, x + h));
+    } // end of method sample
+
+    /*
+      Scrive in m le celle vive del nodo n, il cui angolo in alto a sinistra
+      si trova nella riga y e nella colonna x di m, ignorando quelle che
+      cadono fuori dalla matrice
+    */
+    void extract(Node* n, uint64_t y, uint64_t x, Matrix& m) {
+      if(y >= m.getRows() || x >= m.getColumns()) return;
+      if(n->level == 0) {
+        if(n == cell(true)) m.set(y, x, true);
+        return;
+      }
+      if(n == empty(n->level)) return;
+      uint64_t h = uint64_t(1) << (n->level - 1);
+      extract(n->nw, y, x, m);
+      extract(n->ne, y, x + h, m);
+      extract(n->sw, y + h, x, m);
+      extract(n->se, y + h, x + h, m);
+      return;
+    } // end of method extract
+
+    /*
+      Segna come raggiungibili il nodo n e i suoi quadranti
+    */
+    void mark(Node* n) {
+      std::vector<Node*> stack(1, n);
+      while(!stack.empty()) {
+        Node* m = stack.back();
+        stack.pop_back();
+        if(m->level == 0 || m->marked) continue;
+        m->marked = true;
+        stack.push_back(m->nw);
+        stack.push_back(m->ne);
+        stack.push_back(m->sw);
+        stack.push_back(m->se);
+      } // end while
+      return;
+    } // end of method mark
+
+    /*
+      Se i nodi superano il massimo, libera quelli non raggiungibili dallo
+      stato corrente (root) e dai nodi vuoti. Restituisce true se sono stati
+      liberati dei nodi.
+    */
+    bool collect(Node* root) {
+      if(_nodes <= _maxNodes) return false;
+      mark(root);
+      for(size_t l=1; l < _empty.size(); ++l) mark(_empty[l]);
+      std::fill(_table.begin(), _table.end(), (Node*) NULL);
+      _nodes = 0;
+      for(size_t c=0; c < _chunks.size(); ++c)
+        for(size_t k=0; k < chunkNodes(); ++k) {
+          Node* n = &_chunks[c][k];
+          if(n->level == FREE_NODE) continue;
+          if(!n->marked) {
+            n->level = FREE_NODE;
+            n->next = _free;
+            _free = n;
+            continue;
+          }
+          size_t h = hash(n->nw, n->ne, n->sw, n->se);
+          n->next = _table[h];
+          _table[h] = n;
+          _nodes++;
+        } // end for k
+      // I risultati dei nodi rimasti possono puntare a nodi liberati
+      for(size_t c=0; c < _chunks.size(); ++c)
+        for(size_t k=0; k < chunkNodes(); ++k) {
+          Node* n = &_chunks[c][k];
+          if(n->level == FREE_NODE) continue;
+          if(n->full != NULL && n->full->level != 0 && !n->full->marked)
+            n->full = NULL;
+          if(n->partial != NULL && n->partial->level != 0 &&
+              !n->partial->marked)
+            n->partial = NULL;
+        } // end for k
+      for(size_t c=0; c < _chunks.size(); ++c)
+        for(size_t k=0; k < chunkNodes(); ++k)
+          _chunks[c][k].marked = false;
+      _collections++;
+      return true;
+    } // end of method collect
+
+    /*
+      Avanza di "generations" generazioni un toro le cui dimensioni dividono
+      2^k: lo stato e' il nodo n di livello k che contiene la ripetizione
+      periodica della matrice
+    */
+    Node* advanceAligned(Node* n, unsigned int k, uint64_t generations) {
+      for(unsigned int j=0; j < 64 && (generations >> j) != 0; ++j) {
+        if(!((generations >> j) & 1)) continue;
+        // Il centro di un nodo di livello l+1 >= k+2 formato da quattro
+        // copie di un nodo periodico di livello l e' di nuovo allineato
+        // alla ripetizione
+        unsigned int l = (j + 1 > k + 1 ? j + 1 : k + 1);
+        Node* m = n;
+        for(unsigned int i=k; i < l; ++i) m = join(m, m, m, m);
+        Node* r = result(join(m, m, m, m), j);
+        while(r->level > k) r = r->nw;
+        n = r;
+        collect(n);
+      } // end for j
+      return n;
+    } // end of method advanceAligned
+
+    /*
+      Avanza di "generations" generazioni la matrice m, di dimensioni
+      qualsiasi, campionandola ad ogni passo in un nodo di livello k+1 il cui
+      centro contiene la matrice. Restituisce la matrice calcolata.
+    */
+    Matrix* advanceSampled(const Matrix& m, unsigned int k,
+        uint64_t generations) {
+      unsigned int l = k + 1;
+      unsigned int jmax = l - 2;
+      uint64_t offset = uint64_t(1) << (l - 2);
+      // Per spostare il centro sull'origine si parte da un multiplo delle
+      // dimensioni meno offset
+      uint64_t y = uint64_t(m.getRows()) * offset - offset;
+      uint64_t x = uint64_t(m.getColumns()) * offset - offset;
+      Matrix* current = new Matrix(m);
+      std::unordered_map<Node*, uint64_t> seen; // stato -> generazioni mancanti
+      while(generations > 0) {
+        unsigned int j = jmax;
+        while((uint64_t(1) << j) > generations) j--;
+        Node* n = sample(*current, l, y, x);
+        if(j == jmax) {
+          std::unordered_map<Node*, uint64_t>::iterator it = seen.find(n);
+          if(it != seen.end()) {
+            // Lo stato si ripete ogni it->second - generations generazioni
+            generations %= it->second - generations;
+            seen.clear();
+            continue;
+          }
+          seen[n] = generations;
+        }
+        Node* r = result(n, j);
+        delete current;
+        current = new Matrix(m.getRows(), m.getColumns());
+        extract(r, 0, 0, *current);
+        generations -= uint64_t(1) << j;
+        if(collect(r)) seen.clear();
+      } // end while
+      return current;
+    } // end of method advanceSampled
+
+  // PUBLIC METHODS
+  public:
+
+    /**
+     * Costruisce un calcolatore HashLife che libera i nodi non piu'
+     * necessari quando occupano piu' di "megabytes" megabyte.
+     */
+    HashLife(unsigned long megabytes = HASHLIFE_MEMORY) :
+        _maxNodes(megabytes * 1024 * 1024 / sizeof(Node)), _nodes(0),
+        _peakNodes(0), _collections(0), _table(1 << 16, (Node*) NULL),
+        _free(NULL) {
+      for(unsigned int k=0; k < 2; ++k) {
+        _cells[k].nw = _cells[k].ne = _cells[k].sw = _cells[k].se = NULL;
+        _cells[k].full = _cells[k].partial = NULL;
+        _cells[k].level = 0;
+        _cells[k].marked = false;
+      }
+      _empty.push_back(cell(false));
+      return;
+    } // end of constructor
+
+    /**
+     * Distruttore
+     */
+    ~HashLife() {
+      for(size_t c=0; c < _chunks.size(); ++c)
+        delete[] _chunks[c];
+    } // end of destructor
+
+    /**
+     * Restituisce un puntatore ad una nuova matrice con la generazione
+     * "generations" della matrice m (la generazione 0 e' m stessa).
+     */
+    Matrix* advance(const Matrix& m, uint64_t generations) {
+      unsigned int rows = m.getRows(), cols = m.getColumns();
+      unsigned int k = 1;
+      while((1u << k) < rows || (1u << k) < cols) k++;
+      bool aligned = ((1u << k) % rows == 0 && (1u << k) % cols == 0);
+      if(!aligned) return advanceSampled(m, k, generations);
+      if(k < 2) k = 2;
+      Node* n = advanceAligned(sample(m, k, 0, 0), k, generations);
+      Matrix* result = new Matrix(rows, cols);
+      extract(n, 0, 0, *result);
+      return result;
+    } // end of method advance
+
+    /**
+     * Restituisce il numero di nodi in uso.
+     */
+    size_t getNodes() const {
+      return _nodes;
+    } // end of method getNodes
+
+    /**
+     * Restituisce il numero massimo di nodi in uso contemporaneamente.
+     */
+    size_t getPeakNodes() const {
+      return _peakNodes;
+    } // end of method getPeakNodes
+
+    /**
+     * Restituisce il numero di volte in cui sono stati liberati i nodi non
+     * raggiungibili.
+     */
+    unsigned long getCollections() const {
+      return _collections;
+    } // end of method getCollections
+
+}; // end of class HashLife
+
+} // end of namespace gameoflife
+
+
+#endif // _HASHLIFE_H
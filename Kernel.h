@@ -0,0 +1,505 @@
+/*!
+  \file Kernel.h
+  \brief Kernel di calcolo della generazione successiva su parole di celle
+  \date 17-10-2026
+*/
+
+#ifndef _KERNEL_H
+#define _KERNEL_H 1
+
+#include <string>
+#include "Bits.h"
+
+// Le funzioni del kernel sono sempre espanse inline: cosi' le versioni
+// vettoriali (vedi Simd.h) vengono compilate con l'insieme di istruzioni
+// della funzione che le utilizza.
+#ifdef __GNUC__
+#define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#define KERNEL_INLINE inline
+#endif
+
+
+namespace gameoflife {
+
+/*!
+  \enum Engine
+  \brief Motore utilizzato da Block::compute per calcolare una generazione.
+
+  - ENGINE_SCALAR: conta i vicini di una cella alla volta.
+  - ENGINE_SPLIT: conta i vicini delle celle interne con un ciclo senza
+    controlli sui bordi (vettorizzabile dal compilatore) e tratta a parte le
+    celle sul bordo del blocco.
+  - ENGINE_BITWISE: calcola WORD_BITS celle alla volta sommando le parole dei
+    vicini con sommatori bit a bit (bit-slicing), senza salti condizionati
+    per cella.
+  - ENGINE_LUT: calcola 2x2 celle alla volta con una tabella precalcolata
+    (LifeTable), indicizzata dalle 4x4 celle che le circondano.
+  - ENGINE_TILED: come ENGINE_BITWISE, ma divide il blocco in tessere e
+    non ricalcola quelle che, insieme alle vicine, sono ferme o oscillano
+    con periodo 2.
+  - ENGINE_SPARSE: conta i vicini solo attorno alle celle vive, elencate in
+    ordine (vedi Sparse.h).
+  - ENGINE_AUTO: sceglie ad ogni generazione ENGINE_SPARSE o ENGINE_TILED in
+    base alla densita' della popolazione.
+*/
+enum Engine {
+  ENGINE_SCALAR,
+  ENGINE_SPLIT,
+  ENGINE_BITWISE,
+  ENGINE_LUT,
+  ENGINE_TILED,
+  ENGINE_SPARSE,
+  ENGINE_AUTO
+}; // end of enum Engine
+
+//! Numero di motori disponibili.
+const unsigned int ENGINES = ENGINE_AUTO + 1;
+
+/**
+ * Restituisce il nome del motore.
+ */
+inline const char* engineName(Engine engine) {
+  switch(engine) {
+    case ENGINE_SCALAR: return "scalar";
+    case ENGINE_SPLIT: return "split";
+    case ENGINE_LUT: return "lut";
+    case ENGINE_TILED: return "tiled";
+    case ENGINE_SPARSE: return "sparse";
+    case ENGINE_AUTO: return "auto";
+    default: return "bitwise";
+  }
+} // end of function engineName
+
+/*!
+  \struct Rule
+  \brief Regola totalistica esterna nella notazione Bxx/Syy.
+
+  Il bit c di birth indica che una cella morta con c vicini vivi nasce, il
+  bit c di survival che una cella viva con c vicini vivi sopravvive (c da 0
+  a 8).
+*/
+struct Rule {
+
+  unsigned int birth;
+  unsigned int survival;
+
+  /**
+   * Restituisce true se le regole sono uguali.
+   */
+  bool operator==(const Rule& rule) const {
+    return birth == rule.birth && survival == rule.survival;
+  } // end of method operator==
+
+  /**
+   * Restituisce il valore della generazione successiva di una cella, viva
+   * se alive, con count vicini vivi.
+   */
+  bool next(bool alive, unsigned int count) const {
+    return ((alive ? survival : birth) >> count) & 1;
+  } // end of method next
+
+}; // end of struct Rule
+
+//! Regola del gioco della vita di Conway (B3/S23).
+constexpr Rule CONWAY = { 1u << 3, (1u << 2) | (1u << 3) };
+
+/**
+ * Restituisce un riferimento alla regola in uso, inizialmente CONWAY.
+ */
+inline Rule& activeRule() {
+  static Rule rule = CONWAY;
+  return rule;
+} // end of function activeRule
+
+/**
+ * Legge in rule la regola scritta nella notazione Bxx/Syy (ad esempio
+ * B36/S23), con le cifre da 0 a 8 in qualsiasi ordine. Restituisce false
+ * se il testo non e' una regola.
+ */
+inline bool parseRule(const char* text, Rule& rule) {
+  Rule parsed = { 0, 0 };
+  const char* c = text;
+  if(*c != 'B' && *c != 'b') return false;
+  for(++c; *c >= '0' && *c <= '8'; ++c) parsed.birth |= 1u << (*c - '0');
+  if(*(c++) != '/' || (*c != 'S' && *c != 's')) return false;
+  for(++c; *c >= '0' && *c <= '8'; ++c) parsed.survival |= 1u << (*c - '0');
+  if(*c != '\0') return false;
+  rule = parsed;
+  return true;
+} // end of function parseRule
+
+/**
+ * Restituisce la regola nella notazione Bxx/Syy.
+ */
+inline std::string ruleName(const Rule& rule) {
+  std::string name = "B";
+  for(unsigned int c=0; c <= 8; ++c)
+    if((rule.birth >> c) & 1) name += char('0' + c);
+  name += "/S";
+  for(unsigned int c=0; c <= 8; ++c)
+    if((rule.survival >> c) & 1) name += char('0' + c);
+  return name;
+} // end of function ruleName
+
+/**
+ * Calcola la generazione successiva delle celle interne di una riga
+ * memorizzata un byte per cella (0 o 1): per ogni j da 1 a n-2, next[j] si
+ * ottiene dalle celle j-1, j, j+1 della riga sopra (up), della riga stessa
+ * (mid) e della riga sotto (down). Il ciclo non contiene controlli sui bordi
+ * e puo' essere vettorizzato dal compilatore: la regola viene applicata
+ * leggendo il bit count (cella morta) o 9+count (cella viva) di una maschera
+ * che unisce birth e survival.
+ */
+inline void nextCells(const unsigned char* up, const unsigned char* mid,
+    const unsigned char* down, unsigned char* next, unsigned int n,
+    const Rule& rule) {
+  unsigned int mask = rule.birth | (rule.survival << 9);
+  for(unsigned int j=1; j+1 < n; ++j) {
+    unsigned int count = up[j-1] + up[j] + up[j+1] + mid[j-1] + mid[j+1] +
+        down[j-1] + down[j] + down[j+1];
+    next[j] = (mask >> (count + 9*mid[j])) & 1;
+  } // end for j
+  return;
+} // end of function nextCells
+
+/**
+ * Scrive in cells le prime n celle di row, un byte per cella.
+ */
+inline void unpackCells(const word_t* row, unsigned char* cells,
+    unsigned int n) {
+  for(unsigned int j=0; j < n; ++j)
+    cells[j] = (row[j / WORD_BITS] >> (j % WORD_BITS)) & 1;
+  return;
+} // end of function unpackCells
+
+/**
+ * Scrive in row le celle di cells (un byte per cella) dalla begin alla
+ * end-1, lasciando inalterate le altre.
+ */
+inline void packCells(const unsigned char* cells, word_t* row,
+    unsigned int begin, unsigned int end) {
+  for(unsigned int j=begin; j < end; ) {
+    unsigned int len = WORD_BITS - j % WORD_BITS;
+    if(len > end - j) len = end - j;
+    word_t bits = 0;
+    for(unsigned int k=0; k < len; ++k)
+      bits |= word_t(cells[j+k]) << k;
+    setBits(row, j, len, bits);
+    j += len;
+  } // end for j
+  return;
+} // end of function packCells
+
+/**
+ * Somma di tre bit per ciascuna posizione della parola (full adder): in sum
+ * il bit meno significativo, in carry il riporto. W puo' essere word_t o un
+ * vettore di parole (vedi Simd.h).
+ */
+template<class W>
+KERNEL_INLINE void fullAdd(const W& a, const W& b, const W& c, W& sum,
+    W& carry) {
+  W t = a ^ b;
+  sum = t ^ c;
+  carry = (a & b) | (t & c);
+  return;
+} // end of function fullAdd
+
+/**
+ * Somma di due bit per ciascuna posizione della parola (half adder).
+ */
+template<class W>
+KERNEL_INLINE void halfAdd(const W& a, const W& b, W& sum, W& carry) {
+  sum = a ^ b;
+  carry = a & b;
+  return;
+} // end of function halfAdd
+
+/*!
+  \struct TruthTable
+  \brief Funzione booleana di VARS variabili nota durante la compilazione.
+
+  Il bit k di TABLE e' il valore della funzione quando le variabili valgono
+  i bit di k (la variabile v nel bit v). eval la calcola in f, in parallelo
+  su tutte le posizioni delle parole x[0], ..., x[VARS-1] espandendola sulla
+  variabile piu' significativa (espansione di Shannon): i casi in cui una
+  meta' della tabella e' costante, uguale o complementare all'altra vengono
+  semplificati durante la compilazione.
+*/
+template<unsigned int TABLE, unsigned int VARS>
+struct TruthTable {
+
+  template<class W>
+  static KERNEL_INLINE void eval(const W* x, W& f) {
+    const unsigned int half = 1u << (VARS - 1);
+    const unsigned int ones = (1u << half) - 1;
+    const unsigned int lo = TABLE & ones, hi = (TABLE >> half) & ones;
+    typedef TruthTable<lo, VARS-1> Lo;
+    typedef TruthTable<hi, VARS-1> Hi;
+    W v = x[VARS-1], fLo, fHi;
+    Lo::eval(x, fLo);
+    Hi::eval(x, fHi);
+    if(lo == hi) f = fLo;
+    else if(lo == 0) f = v & fHi;
+    else if(hi == 0) f = ~v & fLo;
+    else if(hi == ones) f = v | fLo;
+    else if(lo == ones) f = ~v | fHi;
+    else if((lo ^ hi) == ones) f = v ^ fLo;
+    else f = (v & fHi) | (~v & fLo);
+    return;
+  } // end of method eval
+
+}; // end of struct TruthTable
+
+template<unsigned int TABLE>
+struct TruthTable<TABLE, 0> {
+
+  template<class W>
+  static KERNEL_INLINE void eval(const W*, W& f) {
+    f = (TABLE & 1 ? ~W() : W());
+    return;
+  } // end of method eval
+
+}; // end of struct TruthTable
+
+/*!
+  \struct FixedRule
+  \brief Regola con maschere note durante la compilazione (vedi Rule).
+
+  apply calcola in next la generazione successiva di una parola di celle
+  (alive) dal numero dei loro vicini vivi, di cui riceve i bit di peso 1
+  (ones), 2 (twos) e 4 (d1 e d2, che insieme danno anche il bit di peso 8).
+  La regola viene applicata come TruthTable di ones, twos, il bit di peso 4
+  e alive; con 8 vicini gli altri bit sono 0, per cui il bit di peso 8
+  serve solo se la regola distingue 8 vicini da 0. Per B3/S23 viene usata
+  direttamente l'espressione piu' breve.
+*/
+template<unsigned int BIRTH, unsigned int SURVIVAL>
+struct FixedRule {
+
+  //! Tabella di ones, twos, fours e alive (bit alive*8 + vicini).
+  static const unsigned int TABLE = (BIRTH & 0xff) | ((SURVIVAL & 0xff) << 8);
+
+  template<class W>
+  KERNEL_INLINE void apply(const W& ones, const W& twos, const W& d1,
+      const W& d2, const W& alive, W& next) const {
+    if(BIRTH == CONWAY.birth && SURVIVAL == CONWAY.survival) {
+      next = twos & ~(d1 | d2) & (ones | alive);
+      return;
+    }
+    W x[4] = { ones, twos, d1 ^ d2, alive };
+    TruthTable<TABLE, 4>::eval(x, next);
+    const unsigned int b8 = (BIRTH >> 8) & 1, s8 = (SURVIVAL >> 8) & 1;
+    if(b8 == (BIRTH & 1) && s8 == (SURVIVAL & 1)) return;
+    W eights = d1 & d2, eight;
+    TruthTable<b8 | (s8 << 1), 1>::eval(&alive, eight);
+    next = (next & ~eights) | (eights & eight);
+    return;
+  } // end of method apply
+
+}; // end of struct FixedRule
+
+/*!
+  \struct AnyRule
+  \brief Regola qualsiasi, con maschere note durante l'esecuzione.
+
+  Come FixedRule, ma la tabella di ones, twos, fours e alive viene valutata
+  per intero come albero di selettori, le cui foglie sono parole di tutti 1
+  o tutti 0: il primo livello, (ones & diff[k]) ^ low[k], usa le foglie
+  precalcolate dal costruttore. apply non contiene salti condizionati.
+*/
+struct AnyRule {
+
+  word_t low[8];     // valore con ones = 0
+  word_t diff[8];    // differenza tra il valore con ones = 1 e con ones = 0
+  word_t eight[2];   // valore con 8 vicini, per alive = 0 e 1
+  bool eights;       // true se la regola distingue 8 vicini da 0
+
+  AnyRule(const Rule& rule) {
+    unsigned int table = (rule.birth & 0xff) | ((rule.survival & 0xff) << 8);
+    for(unsigned int k=0; k < 8; ++k) {
+      low[k] = word_t(0) - ((table >> (2*k)) & 1);
+      diff[k] = low[k] ^ (word_t(0) - ((table >> (2*k + 1)) & 1));
+    } // end for k
+    eight[0] = word_t(0) - ((rule.birth >> 8) & 1);
+    eight[1] = word_t(0) - ((rule.survival >> 8) & 1);
+    eights = ((rule.birth >> 8) & 1) != (rule.birth & 1) ||
+        ((rule.survival >> 8) & 1) != (rule.survival & 1);
+  } // end of constructor
+
+  template<class W>
+  KERNEL_INLINE void apply(const W& ones, const W& twos, const W& d1,
+      const W& d2, const W& alive, W& next) const {
+    W fours = d1 ^ d2;
+    W t[8];
+    for(unsigned int k=0; k < 8; ++k) t[k] = (ones & diff[k]) ^ low[k];
+    for(unsigned int k=0; k < 4; ++k)
+      t[k] = t[2*k] ^ (twos & (t[2*k] ^ t[2*k+1]));
+    for(unsigned int k=0; k < 2; ++k)
+      t[k] = t[2*k] ^ (fours & (t[2*k] ^ t[2*k+1]));
+    next = t[0] ^ (alive & (t[0] ^ t[1]));
+    if(!eights) return;
+    W e = (d1 & d2);
+    next = (next & ~e) | (e & ((alive & eight[1]) | (~alive & eight[0])));
+  } // end of method apply
+
+}; // end of struct AnyRule
+
+/**
+ * Calcola in next la generazione successiva di WORD_BITS celle con la
+ * regola rule (FixedRule o AnyRule). Gli altri parametri sono le parole
+ * della riga sopra (a), della riga della cella (c) e della riga sotto (b),
+ * gia' traslate in modo che in ogni posizione si trovi il vicino a ovest
+ * (W), allineato (nessun suffisso) o a est (E).
+ *
+ * Il numero di vicini vivi viene calcolato in parallelo su tutte le
+ * posizioni come somma binaria (bit-slicing) e la regola viene applicata
+ * come espressione booleana sui bit della somma: con B3/S23 una cella e'
+ * viva nella generazione successiva se ha 3 vicini, oppure se e' viva e ne
+ * ha 2.
+ *
+ * Le parole vengono passate per riferimento e il risultato in next (come
+ * in fullAdd, halfAdd e nelle regole): passare o restituire per valore i
+ * vettori di Simd.h in funzioni senza l'attributo target fa emettere a GCC
+ * l'avviso -Wpsabi sul cambio di ABI, anche se vengono sempre espanse.
+ */
+template<class R, class W>
+KERNEL_INLINE void nextWord(const R& rule, const W& aW, const W& a,
+    const W& aE, const W& cW, const W& c, const W& cE, const W& bW,
+    const W& b, const W& bE, W& next) {
+  W s1, c1, s2, c2, s3, c3, ones, c4;
+  fullAdd(aW, a, aE, s1, c1);
+  fullAdd(cW, cE, bW, s2, c2);
+  halfAdd(b, bE, s3, c3);
+  fullAdd(s1, s2, s3, ones, c4);   // bit di peso 1
+  W t, d1, twos, d2;
+  fullAdd(c1, c2, c3, t, d1);
+  halfAdd(t, c4, twos, d2);        // bit di peso 2 (d1, d2 di peso 4)
+  rule.apply(ones, twos, d1, d2, c, next);
+  return;
+} // end of function nextWord
+
+/**
+ * Calcola le parole di indice da begin a end-1 della generazione successiva
+ * di una riga di celle con la regola rule (vedi nextWord), dati la riga
+ * sopra (above), la riga stessa (row) e la riga sotto (below). Le righe
+ * sono nel formato di Slice: la parola di indice -1 contiene nel bit piu'
+ * significativo la cella a sinistra della prima colonna, e la cella a destra
+ * dell'ultima colonna segue l'ultima cella della riga; "words" e' il
+ * numero di parole delle celle della riga e lastBit la posizione
+ * dell'ultima cella nell'ultima parola.
+ */
+template<class R>
+KERNEL_INLINE void nextRowRange(const R& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end) {
+  const unsigned int hi = WORD_BITS - 1;
+  for(unsigned int w=begin; w < end; ++w) {
+    const word_t* pa = above + w;
+    const word_t* pc = row + w;
+    const word_t* pb = below + w;
+    nextWord(rule, (pa[0] << 1) | (pa[-1] >> hi), pa[0],
+             (pa[0] >> 1) | (pa[1] << hi),
+             (pc[0] << 1) | (pc[-1] >> hi), pc[0],
+             (pc[0] >> 1) | (pc[1] << hi),
+             (pb[0] << 1) | (pb[-1] >> hi), pb[0],
+             (pb[0] >> 1) | (pb[1] << hi), out[w]);
+  } // end for w
+  if(begin < end && end == words) out[words-1] &= lowMask(lastBit+1);
+  return;
+} // end of function nextRowRange
+
+/*!
+  \struct LifeTable
+  \brief Tabella della generazione successiva di un quadrato di 2x2 celle.
+
+  L'elemento di indice x contiene la generazione successiva delle 2x2 celle
+  centrali del quadrato di 4x4 celle rappresentato da x: i bit da 4r a 4r+3
+  di x sono le celle della riga r (la colonna c nel bit 4r+c). Il risultato
+  ha nel bit 0 e 1 le celle centrali della riga 1, nel bit 2 e 3 quelle della
+  riga 2. La tabella di CONWAY viene calcolata durante la compilazione (vedi
+  LIFE_TABLE), quella delle altre regole quando vengono attivate (vedi
+  activeTable).
+*/
+struct LifeTable {
+
+  Rule rule;
+  unsigned char next[1 << 16];
+
+  constexpr LifeTable(Rule r = CONWAY) : rule(r), next() {
+    for(unsigned int x=0; x < (1u << 16); ++x) {
+      unsigned char result = 0;
+      for(unsigned int k=0; k < 4; ++k) {
+        // Cella (r,c) e il quadrato di 3x3 celle centrato su di essa
+        unsigned int cell = 4*(1 + k/2) + 1 + k%2;
+        unsigned int square = 0x777u << (cell - 5);
+        unsigned int alive = (x >> cell) & 1;
+        unsigned int count = __builtin_popcount(x & square) - alive;
+        if(((alive ? r.survival : r.birth) >> count) & 1) result |= 1 << k;
+      } // end for k
+      next[x] = result;
+    } // end for x
+  } // end of constructor
+
+}; // end of struct LifeTable
+
+//! Tabella di CONWAY utilizzata da ENGINE_LUT.
+constexpr LifeTable LIFE_TABLE = LifeTable();
+
+/**
+ * Restituisce la tabella della regola restituita da activeRule: LIFE_TABLE
+ * per CONWAY, altrimenti una tabella calcolata (una sola volta per regola).
+ */
+inline const LifeTable& activeTable() {
+  static LifeTable* table = NULL;
+  const Rule& rule = activeRule();
+  if(rule == CONWAY) return LIFE_TABLE;
+  if(table == NULL || !(table->rule == rule)) {
+    delete table;
+    table = new LifeTable(rule);
+  }
+  return *table;
+} // end of function activeTable
+
+/**
+ * Calcola la generazione successiva di due righe di celle (out0 e out1),
+ * dati la riga sopra la prima (r0), le due righe (r1 e r2) e la riga sotto
+ * la seconda (r3), nel formato di Slice (vedi nextRowRange). Le celle sono
+ * calcolate a coppie con la tabella table.
+ */
+inline void nextRowPair(const LifeTable& table, const word_t* r0,
+    const word_t* r1, const word_t* r2, const word_t* r3, unsigned int words,
+    unsigned int lastBit, word_t* out0, word_t* out1) {
+  const word_t* rows[4] = { r0, r1, r2, r3 };
+  for(unsigned int w=0; w < words; ++w) {
+    // Finestra delle celle da 64w-1 a 64w+62 e celle 64w+63, 64w+64
+    word_t lo[4], hi[4];
+    for(unsigned int r=0; r < 4; ++r) {
+      const word_t* p = rows[r] + w;
+      lo[r] = (p[0] << 1) | (p[-1] >> (WORD_BITS-1));
+      hi[r] = (p[0] >> (WORD_BITS-1)) | ((p[1] & 1) << 1);
+    }
+    word_t a = 0, b = 0;
+    for(unsigned int k=0; k < WORD_BITS; k += 2) {
+      unsigned int x = 0;
+      for(unsigned int r=0; r < 4; ++r) {
+        word_t nibble = (k + 4 <= WORD_BITS ? (lo[r] >> k) & 15 :
+            (lo[r] >> k) | (hi[r] << 2));
+        x |= nibble << (4*r);
+      }
+      word_t result = table.next[x];
+      a |= (result & 3) << k;
+      b |= (result >> 2) << k;
+    } // end for k
+    out0[w] = a;
+    out1[w] = b;
+  } // end for w
+  out0[words-1] &= lowMask(lastBit+1);
+  out1[words-1] &= lowMask(lastBit+1);
+  return;
+} // end of function nextRowPair
+
+} // end of namespace gameoflife
+
+
+#endif // _KERNEL_H
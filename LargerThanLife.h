@@ -0,0 +1,151 @@
+/*!
+  \file LargerThanLife.h
+  \brief Regole Larger than Life, con vicinato di raggio fino a 10
+  \date 18-10-2026
+*/
+
+#ifndef _LARGER_THAN_LIFE_H
+#define _LARGER_THAN_LIFE_H 1
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Bits.h"
+#include "Slice.h"
+
+
+namespace gameoflife {
+
+//! Raggio massimo del vicinato di una regola Larger than Life.
+const unsigned int MAX_RADIUS = 10;
+
+/*!
+  \struct LtlRule
+  \brief Regola Larger than Life nella notazione Rr,C0,Mm,Ss1..s2,Bb1..b2,NM.
+
+  Il vicinato di una cella e' il quadrato di (2r+1)x(2r+1) celle centrato
+  su di essa, compresa la cella stessa se middle e' true. Una cella viva
+  sopravvive se i vicini vivi sono da sMin a sMax, una cella morta nasce se
+  sono da bMin a bMax. Con radius 0 nessuna regola Larger than Life e' in
+  uso.
+*/
+struct LtlRule {
+
+  unsigned int radius;
+  bool middle;
+  unsigned int sMin, sMax;
+  unsigned int bMin, bMax;
+
+  /**
+   * Restituisce il valore della generazione successiva di una cella, viva
+   * se alive, con count vicini vivi.
+   */
+  bool next(bool alive, unsigned int count) const {
+    return alive ? (count >= sMin && count <= sMax) :
+        (count >= bMin && count <= bMax);
+  } // end of method next
+
+}; // end of struct LtlRule
+
+/**
+ * Restituisce un riferimento alla regola Larger than Life in uso,
+ * inizialmente nessuna (raggio 0).
+ */
+inline LtlRule& activeLtlRule() {
+  static LtlRule rule = { 0, false, 0, 0, 0, 0 };
+  return rule;
+} // end of function activeLtlRule
+
+/**
+ * Legge in rule la regola scritta nella notazione Rr,C0,Mm,Ss1..s2,Bb1..b2,NM
+ * (ad esempio la regola di Bosco R5,C0,M1,S34..58,B34..45,NM), con r da 1 a
+ * MAX_RADIUS. Sono ammessi solo due stati (C0 o C2) e il vicinato quadrato
+ * (NM). Restituisce false se il testo non e' una regola di questo tipo.
+ */
+inline bool parseLtlRule(const char* text, LtlRule& rule) {
+  LtlRule parsed;
+  unsigned int states, middle;
+  char neighborhood;
+  int length = 0;
+  if(sscanf(text, "R%u,C%u,M%u,S%u..%u,B%u..%u,N%c%n", &parsed.radius,
+      &states, &middle, &parsed.sMin, &parsed.sMax, &parsed.bMin,
+      &parsed.bMax, &neighborhood, &length) != 8 || text[length] != '\0')
+    return false;
+  if(parsed.radius < 1 || parsed.radius > MAX_RADIUS || states > 2 ||
+      states == 1 || middle > 1 || neighborhood != 'M')
+    return false;
+  parsed.middle = (middle == 1);
+  rule = parsed;
+  return true;
+} // end of function parseLtlRule
+
+/**
+ * Restituisce la regola nella notazione Rr,C0,Mm,Ss1..s2,Bb1..b2,NM.
+ */
+inline std::string ltlRuleName(const LtlRule& rule) {
+  char name[64];
+  snprintf(name, sizeof(name), "R%u,C0,M%u,S%u..%u,B%u..%u,NM", rule.radius,
+      rule.middle ? 1 : 0, rule.sMin, rule.sMax, rule.bMin, rule.bMax);
+  return name;
+} // end of function ltlRuleName
+
+/**
+ * Calcola in next la generazione successiva di s con la regola rule, per le
+ * colonne da -e a getColumns()+e-1: le colonne fantasma di s (almeno
+ * e+radius per lato) forniscono i vicini delle colonne di bordo, mentre le
+ * righe si chiudono in modo toroidale senza usare quelle fantasma.
+ *
+ * Il numero di vicini vivi di ogni cella costa O(1) qualunque sia il
+ * raggio: per ogni riga le somme orizzontali di 2r+1 celle (sums, una riga
+ * per riga di s) vengono aggiornate scorrendo la riga, e le somme verticali
+ * di 2r+1 somme orizzontali (counts) scorrendo le righe, aggiungendo la riga
+ * che entra nel vicinato e togliendo quella che esce. sums e counts sono
+ * aree di lavoro.
+ */
+inline void nextLargerThanLife(const Slice& s, Slice& next,
+    const LtlRule& rule, unsigned int e, std::vector<unsigned char>& sums,
+    std::vector<unsigned short>& counts) {
+  int rows = s.getRows();
+  int r = rule.radius;
+  int first = -(int)e;
+  int width = s.getColumns() + 2*e;
+  sums.resize(size_t(rows) * width);
+  counts.assign(width, 0);
+  // Somme orizzontali
+  for(int i=0; i < rows; ++i) {
+    unsigned char* sum = &sums[size_t(i) * width];
+    int window = 0;
+    for(int j = first - r; j <= first + r; ++j) window += s.get(i, j);
+    sum[0] = window;
+    for(int k=1; k < width; ++k) {
+      int j = first + k;
+      window += s.get(i, j + r) - s.get(i, j - r - 1);
+      sum[k] = window;
+    } // end for k
+  } // end for i
+  // Somme verticali della prima riga (le righe si ripetono se sono meno
+  // di 2r+1, come sul toro)
+  for(int di = -r; di <= r; ++di) {
+    const unsigned char* sum =
+        &sums[size_t(((di % rows) + rows) % rows) * width];
+    for(int k=0; k < width; ++k) counts[k] += sum[k];
+  } // end for di
+  for(int i=0; i < rows; ++i) {
+    for(int k=0; k < width; ++k) {
+      int j = first + k;
+      bool alive = s.get(i, j);
+      next.set(i, j, rule.next(alive, counts[k] - (rule.middle ? 0 : alive)));
+    } // end for k
+    // Il vicinato scende di una riga
+    const unsigned char* in = &sums[size_t((i + r + 1) % rows) * width];
+    const unsigned char* out = &sums[size_t(((i - r) % rows + rows) % rows) *
+        width];
+    for(int k=0; k < width; ++k) counts[k] += in[k] - out[k];
+  } // end for i
+  return;
+} // end of function nextLargerThanLife
+
+} // end of namespace gameoflife
+
+
+#endif // _LARGER_THAN_LIFE_H
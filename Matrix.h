@@ -11,6 +11,8 @@
 #include <iostream>
 #include <cstring>
 #include <cmath>
+#include <utility>
+#include "Bits.h"
 #include "Block.h"
 
 
@@ -21,12 +23,17 @@ namespace gameoflife {
   \brief Matrice che rappresenta il Gioco della Vita.
 
   La classe rappresenta la matrice del gioco della vita attraverso un
-  array bidimensionale di bool. La classe viene costruita passandogli le
-  dimensioni della matrice (numero di righe e di colonne) e la densita', un 
-  valore tra 0 e 1 che rappresenta la proporzione tra celle vive e celle morte 
-  all'interno della matrice; le celle vengono quindi inizializzate in modo
-  casuale tenendo conto della densità, assegnando il valore true alle celle 
-  vive e false alle celle morte.
+  array bidimensionale di parole, in cui ogni riga memorizza le celle in
+  forma compatta, un bit per cella (vedi Bits.h). La classe viene costruita
+  passandogli le dimensioni della matrice (numero di righe e di colonne) e
+  la densita', un valore tra 0 e 1 che rappresenta la proporzione tra celle
+  vive e celle morte all'interno della matrice; le celle vengono quindi
+  inizializzate in modo casuale tenendo conto della densità, assegnando il
+  valore true alle celle vive e false alle celle morte.
+
+  Ogni riga ha una parola in piu' per lato, che non fa parte delle celle:
+  wrapRow vi scrive le colonne fantasma del toro, per cui le righe possono
+  essere passate direttamente ai kernel di Kernel.h (vedi ThreadedLife).
 */
 class Matrix {
 
@@ -35,8 +42,16 @@ class Matrix {
     
     unsigned int _rows;
     unsigned int _cols;
+    unsigned int _words; // parole per riga
     
-    bool** _matrix;  // _matrix[_rows][_cols]
+    word_t** _matrix;  // _matrix[_rows][_words], da -1 a _words
+
+    /*
+      Alloca una riga azzerata, con una parola in piu' per lato.
+    */
+    word_t* newRow() const {
+      return new word_t[_words + 2]() + 1;
+    } // end of method newRow
 
   // PUBLIC METHODS
   public:
@@ -45,37 +60,53 @@ class Matrix {
      * Costruisce una matrice che rappresenta il gioco della vita di dimensione
      * rows*cols, senza inizializzare gli elementi.
      */
-    Matrix(unsigned int rows, unsigned int cols) : _rows(rows), _cols(cols) { 
-      _matrix = new bool*[_rows];
+    Matrix(unsigned int rows, unsigned int cols) : 
+        _rows(rows), _cols(cols), _words(wordsFor(cols)) { 
+      _matrix = new word_t*[_rows];
       for(int i=0; i < _rows; ++i)
-        _matrix[i] = new bool[_cols];
+        _matrix[i] = newRow();
       return;
     } // end of default constructor
     
     /**
      * Costruisce una matrice che rappresenta il gioco della vita di dimensione
      * rows*cols, popolandola in modo casuale con una densita' di popolazione
-     * passata come parametro "density" (valore da 0 a 1).
+     * passata come parametro "density" (valore da 0 a 1). Il generatore di
+     * numeri casuali viene inizializzato con "seed": a parita' di seed si
+     * ottiene la stessa matrice.
      */
-    Matrix(unsigned int rows, unsigned int cols, float density) :
-        _rows(rows), _cols(cols) {
-      _matrix = new bool*[_rows];
+    Matrix(unsigned int rows, unsigned int cols, float density,
+        unsigned int seed) : _rows(rows), _cols(cols), _words(wordsFor(cols)) {
+      _matrix = new word_t*[_rows];
       if(density > 1) density = 1;
-      srand(time(NULL));
+      srand(seed);
       for(int i = 0; i < _rows; ++i) {
-        _matrix[i] = new bool[_cols];
+        _matrix[i] = newRow();
         for(int j = 0; j < _cols; ++j)
-          _matrix[i][j] = (rand()/(float(RAND_MAX)+1)) < density;
+          setBit(_matrix[i], j, (rand()/(float(RAND_MAX)+1)) < density);
       } // end for i
       return;
     } // end of constructor
     
+    /**
+     * Costruttore di copia.
+     */
+    Matrix(const Matrix& m) : _rows(m._rows), _cols(m._cols),
+        _words(m._words) {
+      _matrix = new word_t*[_rows];
+      for(int i=0; i < _rows; ++i) {
+        _matrix[i] = newRow();
+        memcpy(_matrix[i], m._matrix[i], sizeof(word_t)*_words);
+      }
+      return;
+    } // end of copy constructor
+
     /**
      * Distruttore
      */
     ~Matrix() {
       for(int i=0; i < _rows; ++i)
-        delete[] _matrix[i];
+        delete[] (_matrix[i] - 1);
       delete[] _matrix;
       return;
     } // end of destructor
@@ -95,25 +126,109 @@ class Matrix {
     } // end of method getColumns();
     
     /**
-     * Restituisce l'elemento nella riga i - colonna j.
+     * Restituisce il numero di parole di una riga.
      */
-    bool get(unsigned int i, unsigned int j) {
-      return &_matrix[i][j];
-    } // end of method get
-    
+    unsigned int getWords() const {
+      return _words;
+    } // end of method getWords
+
+    /**
+     * Restituisce la riga i, nel formato dei kernel (vedi nextRowRange) se
+     * le sue colonne fantasma sono state scritte da wrapRow.
+     */
+    word_t* row(unsigned int i) {
+      return _matrix[i];
+    } // end of method row
+
+    /**
+     * Restituisce la riga i (in sola lettura).
+     */
+    const word_t* row(unsigned int i) const {
+      return _matrix[i];
+    } // end of method row
+
+    /**
+     * Scrive le colonne fantasma della riga i: a sinistra della prima
+     * colonna l'ultima, a destra dell'ultima la prima, come sul toro. Se le
+     * colonne non sono un multiplo di WORD_BITS la colonna fantasma di
+     * destra si trova nell'ultima parola della riga: i kernel la ignorano
+     * nel risultato, ma finche' non viene cancellata da unwrapRow la riga
+     * non va confrontata con operator==.
+     */
+    void wrapRow(unsigned int i) {
+      word_t* row = _matrix[i];
+      row[-1] = word_t(getBit(row, _cols - 1)) << (WORD_BITS - 1);
+      setBit(row, _cols, getBit(row, 0));
+      return;
+    } // end of method wrapRow
+
+    /**
+     * Cancella le colonne fantasma della riga i scritte da wrapRow.
+     */
+    void unwrapRow(unsigned int i) {
+      _matrix[i][-1] = 0;
+      setBit(_matrix[i], _cols, false);
+      return;
+    } // end of method unwrapRow
+
+    /**
+     * Sposta la riga i, con le sue colonne fantasma, in una nuova area di
+     * memoria scritta per prima dal thread chiamante: le pagine nuove
+     * vengono allocate sul nodo NUMA di quel thread (vedi Numa.h). Le righe
+     * corte condividono le pagine, per cui conviene che ogni thread sposti
+     * righe consecutive.
+     */
+    void relocateRow(unsigned int i) {
+      word_t* row = newRow();
+      memcpy(row - 1, _matrix[i] - 1, sizeof(word_t) * (_words + 2));
+      delete[] (_matrix[i] - 1);
+      _matrix[i] = row;
+      return;
+    } // end of method relocateRow
+
+    /**
+     * Scambia le celle con quelle della matrice m, delle stesse dimensioni,
+     * senza copiarle.
+     */
+    void swap(Matrix& m) {
+      std::swap(_matrix, m._matrix);
+      return;
+    } // end of method swap
+
     /**
      * Restituisce l'elemento nella riga i - colonna j.
      */
     bool get(unsigned int i, unsigned int j) const {
-      return _matrix[i][j];
+      return getBit(_matrix[i], j);
     } // end of method get
     
+    /**
+     * Imposta l'elemento nella riga i - colonna j.
+     */
+    void set(unsigned int i, unsigned int j, bool value) {
+      setBit(_matrix[i], j, value);
+      return;
+    } // end of method set
+    
+    /**
+     * Restituisce true se la matrice ha le stesse dimensioni e le stesse
+     * celle della matrice m.
+     */
+    bool operator==(const Matrix& m) const {
+      if(_rows != m._rows || _cols != m._cols) return false;
+      for(int i=0; i < _rows; ++i)
+        if(memcmp(_matrix[i], m._matrix[i], sizeof(word_t)*_words) != 0)
+          return false;
+      return true;
+    } // end of operator==
+    
     /**
      * Dato il parametro nBlocks (numero di blocchi in cui suddividere la 
      * matrice) restituisce l'i-esimo blocco della suddivisione (i da 0 a 
-     * nBlocks - 1).
+     * nBlocks - 1), con "depth" colonne fantasma per lato.
      */
-    Block* getBlock(unsigned int nBlocks, unsigned int i) const {
+    Block* getBlock(unsigned int nBlocks, unsigned int i,
+        unsigned int depth = 1) const {
       if(nBlocks > _cols) { nBlocks = _cols; }
       if(i > nBlocks - 1) { i = nBlocks - 1; }
       // Calcolo della dimensione del blocco
@@ -122,7 +237,7 @@ class Matrix {
       int dim = ( i < rest ? div+1 : div );
       int pos = ( i < rest ? (div+1)*i : div*i + rest );
       // Costruisce e restituisce il blocco
-      return new Block(i, dim, pos, _matrix, _rows, _cols);
+      return new Block(i, dim, pos, _matrix, _rows, _cols, depth);
     } // end of method getBlock
     
     /**
@@ -131,10 +246,8 @@ class Matrix {
      */
     void setBlock(const Block* const block) {
       int pos = block->getPosition();
-      for(int i=0; i < block->getRows(); ++i) {
-        for(int j=0; j < block->getColumns(); ++j)
-          _matrix[i][pos+j] = block->get(i,j);
-      }
+      for(int i=0; i < block->getRows(); ++i)
+        copyBits(_matrix[i], pos, block->getRow(i), 0, block->getColumns());
       return;
     } // end of method setBlock
     
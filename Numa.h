@@ -0,0 +1,187 @@
+/*!
+  \file Numa.h
+  \brief Posizionamento della memoria sui nodi NUMA e fissaggio dei thread
+  \date 18-10-2026
+*/
+
+#ifndef _NUMA_H
+#define _NUMA_H 1
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <sched.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+
+namespace gameoflife {
+
+/*!
+  \enum NumaPolicy
+  \brief Politica con cui vengono posizionate le pagine delle fasce.
+
+  Con NUMA_FIRST_TOUCH le pagine di una fascia restano sul nodo del thread
+  che la scrive per primo (il thread che la calcolera'); con NUMA_LOCAL
+  vengono inoltre spostate sul nodo di quel thread se si trovano altrove, e
+  il nodo diventa quello preferito (MPOL_PREFERRED) ma non obbligato: se e'
+  pieno le pagine possono finire su un altro nodo, invece di esaurire la
+  memoria. Con NUMA_INTERLEAVE le pagine vengono distribuite a turno su
+  tutti i nodi.
+*/
+enum NumaPolicy {
+  NUMA_FIRST_TOUCH,
+  NUMA_LOCAL,
+  NUMA_INTERLEAVE
+};
+
+//! Numero di politiche NUMA.
+const unsigned int NUMA_POLICIES = 3;
+
+/**
+ * Restituisce il nome della politica policy.
+ */
+inline const char* numaPolicyName(NumaPolicy policy) {
+  switch(policy) {
+    case NUMA_LOCAL: return "local";
+    case NUMA_INTERLEAVE: return "interleave";
+    default: return "first-touch";
+  }
+} // end of function numaPolicyName
+
+/**
+ * Restituisce un riferimento alla politica NUMA in uso, inizialmente
+ * NUMA_FIRST_TOUCH.
+ */
+inline NumaPolicy& activeNumaPolicy() {
+  static NumaPolicy policy = NUMA_FIRST_TOUCH;
+  return policy;
+} // end of function activeNumaPolicy
+
+/**
+ * Restituisce i nodi NUMA in linea, letti da /sys (il solo nodo 0 se non
+ * sono disponibili).
+ */
+inline const std::vector<unsigned int>& numaNodes() {
+  static std::vector<unsigned int> nodes;
+  if(!nodes.empty()) return nodes;
+  FILE* file = fopen("/sys/devices/system/node/online", "r");
+  unsigned int first, last;
+  int n;
+  while(file != NULL && (n = fscanf(file, "%u-%u", &first, &last)) >= 1) {
+    if(n == 1) last = first;
+    for(unsigned int node=first; node <= last; ++node) nodes.push_back(node);
+    if(fgetc(file) != ',') break;
+  } // end while
+  if(file != NULL) fclose(file);
+  if(nodes.empty()) nodes.push_back(0);
+  return nodes;
+} // end of function numaNodes
+
+/**
+ * Restituisce il nodo NUMA della pagina che contiene address, o -1 se non
+ * e' noto.
+ */
+inline int numaNodeOf(const void* address) {
+  int node = -1;
+  if(syscall(SYS_get_mempolicy, &node, NULL, 0, address,
+      MPOL_F_NODE | MPOL_F_ADDR) != 0)
+    return -1;
+  return node;
+} // end of function numaNodeOf
+
+/**
+ * Restituisce il nodo NUMA della CPU su cui si trova il thread chiamante, o
+ * -1 se non e' noto.
+ */
+inline int currentNumaNode() {
+  unsigned int cpu, node;
+  if(syscall(SYS_getcpu, &cpu, &node, NULL) != 0) return -1;
+  return node;
+} // end of function currentNumaNode
+
+/**
+ * Restituisce i nodi delle pagine di addresses, in ordine crescente e
+ * separati da virgole ("?" per quelle di nodo non noto).
+ */
+inline std::string numaNodeList(const std::vector<const void*>& addresses) {
+  std::vector<int> nodes;
+  for(unsigned int k=0; k < addresses.size(); ++k)
+    nodes.push_back(numaNodeOf(addresses[k]));
+  std::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  std::string list;
+  for(unsigned int k=0; k < nodes.size(); ++k) {
+    if(k > 0) list += ",";
+    list += (nodes[k] < 0 ? std::string("?") : std::to_string(nodes[k]));
+  } // end for k
+  return list;
+} // end of function numaNodeList
+
+/**
+ * Applica la politica policy alle pagine che contengono i bytes byte da
+ * address (vedi NumaPolicy), spostando quelle gia' allocate altrove; con
+ * NUMA_LOCAL il nodo (preferito) e' quello del thread chiamante.
+ * Restituisce false se il sistema non lo consente: le pagine restano dove
+ * sono.
+ */
+inline bool applyNumaPolicy(const void* address, size_t bytes,
+    NumaPolicy policy) {
+  if(policy == NUMA_FIRST_TOUCH || bytes == 0) return true;
+  const unsigned int MASK_WORDS = 16;
+  unsigned long mask[MASK_WORDS] = { 0 };
+  int mode = MPOL_INTERLEAVE;
+  if(policy == NUMA_LOCAL) {
+    int node = currentNumaNode();
+    if(node < 0) return false;
+    mode = MPOL_PREFERRED;
+    mask[node / 64] |= 1ul << (node % 64);
+  }
+  else
+    for(unsigned int k=0; k < numaNodes().size(); ++k)
+      mask[numaNodes()[k] / 64] |= 1ul << (numaNodes()[k] % 64);
+  uintptr_t page = sysconf(_SC_PAGESIZE);
+  uintptr_t begin = (uintptr_t)address & ~(page - 1);
+  uintptr_t end = ((uintptr_t)address + bytes + page - 1) & ~(page - 1);
+  return syscall(SYS_mbind, begin, end - begin, mode, mask,
+      MASK_WORDS * 64 + 1, MPOL_MF_MOVE) == 0;
+} // end of function applyNumaPolicy
+
+/**
+ * Restituisce le CPU su cui il processo puo' essere eseguito, lette alla
+ * prima chiamata: va chiamata la prima volta prima di fissare un thread
+ * (pinThread), perche' i thread creati dopo ereditano le CPU del creatore.
+ */
+inline const std::vector<int>& allowedCpus() {
+  static std::vector<int> cpus;
+  if(!cpus.empty()) return cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if(sched_getaffinity(0, sizeof(set), &set) == 0)
+    for(int cpu=0; cpu < CPU_SETSIZE; ++cpu)
+      if(CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+  return cpus;
+} // end of function allowedCpus
+
+/**
+ * Fissa il thread chiamante alla index-esima CPU di allowedCpus (modulo il
+ * loro numero) e la restituisce, o restituisce -1 se non e' possibile.
+ */
+inline int pinThread(unsigned int index) {
+  const std::vector<int>& cpus = allowedCpus();
+  if(cpus.empty()) return -1;
+  int cpu = cpus[index % cpus.size()];
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if(sched_setaffinity(0, sizeof(set), &set) != 0) return -1;
+  return cpu;
+} // end of function pinThread
+
+} // end of namespace gameoflife
+
+
+#endif // _NUMA_H
@@ -0,0 +1,325 @@
+/*!
+  \file Simd.h
+  \brief Versioni vettoriali (SSE2, AVX2, AVX-512) del kernel bit a bit
+  \date 17-10-2026
+*/
+
+#ifndef _SIMD_H
+#define _SIMD_H 1
+
+#include <cstddef>
+#include <cstring>
+#include "Bits.h"
+#include "Kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GAMEOFLIFE_X86_SIMD 1
+#endif
+
+
+namespace gameoflife {
+
+/*!
+  \enum Isa
+  \brief Insieme di istruzioni utilizzato dal kernel bit a bit.
+
+  Con ISA_NONE il kernel elabora una parola (64 celle) alla volta; con le
+  altre estensioni elabora 2 (SSE2), 4 (AVX2) o 8 (AVX-512) parole per
+  istruzione, cioe' 128, 256 o 512 celle.
+*/
+enum Isa {
+  ISA_NONE,
+  ISA_SSE2,
+  ISA_AVX2,
+  ISA_AVX512
+}; // end of enum Isa
+
+/**
+ * Restituisce il nome dell'insieme di istruzioni.
+ */
+inline const char* isaName(Isa isa) {
+  switch(isa) {
+    case ISA_SSE2: return "sse2";
+    case ISA_AVX2: return "avx2";
+    case ISA_AVX512: return "avx512";
+    default: return "none";
+  }
+} // end of function isaName
+
+/**
+ * Restituisce true se la CPU (e il sistema operativo) supportano l'insieme
+ * di istruzioni isa.
+ */
+inline bool isaSupported(Isa isa) {
+#ifdef GAMEOFLIFE_X86_SIMD
+  __builtin_cpu_init();
+  switch(isa) {
+    case ISA_NONE: return true;
+    case ISA_SSE2: return __builtin_cpu_supports("sse2");
+    case ISA_AVX2: return __builtin_cpu_supports("avx2");
+    case ISA_AVX512: return __builtin_cpu_supports("avx512f");
+  }
+  return false;
+#else
+  return isa == ISA_NONE;
+#endif
+} // end of function isaSupported
+
+/**
+ * Restituisce l'insieme di istruzioni piu' ampio supportato dalla CPU.
+ */
+inline Isa detectIsa() {
+  if(isaSupported(ISA_AVX512)) return ISA_AVX512;
+  if(isaSupported(ISA_AVX2)) return ISA_AVX2;
+  if(isaSupported(ISA_SSE2)) return ISA_SSE2;
+  return ISA_NONE;
+} // end of function detectIsa
+
+/**
+ * Restituisce un riferimento all'insieme di istruzioni in uso, inizialmente
+ * quello rilevato da detectIsa.
+ */
+inline Isa& activeIsa() {
+  static Isa isa = detectIsa();
+  return isa;
+} // end of function activeIsa
+
+/*
+  Calcola le parole da begin a end-1 della riga successiva una alla volta
+  con nextRowRange e la regola rule. Se TRACK e' true accumula in diff1 le
+  differenze dalla riga corrente (row) e in diff2 quelle dal contenuto
+  precedente di out. Nell'ultima parola della riga le colonne fantasma
+  (oltre lastBit) vengono ignorate.
+*/
+template<bool TRACK, class R>
+KERNEL_INLINE void nextRowWords(const R& rule,
+    const word_t* above, const word_t* row, const word_t* below,
+    unsigned int words, unsigned int lastBit, word_t* out,
+    unsigned int begin, unsigned int end, word_t* diff1, word_t* diff2) {
+  if(!TRACK) {
+    nextRowRange(rule, above, row, below, words, lastBit, out, begin, end);
+    return;
+  }
+  for(unsigned int w=begin; w < end; ++w) {
+    word_t mask = (w + 1 == words ? lowMask(lastBit+1) : ~word_t(0));
+    word_t old = out[w] & mask;
+    nextRowRange(rule, above, row, below, words, lastBit, out, w, w+1);
+    diff1[w] |= out[w] ^ (row[w] & mask);
+    diff2[w] |= out[w] ^ old;
+  } // end for w
+  return;
+} // end of function nextRowWords
+
+#ifdef GAMEOFLIFE_X86_SIMD
+
+typedef word_t vec128_t __attribute__((vector_size(16)));
+typedef word_t vec256_t __attribute__((vector_size(32)));
+typedef word_t vec512_t __attribute__((vector_size(64)));
+
+/*
+  Calcola le parole da begin a end-1 della riga successiva con vettori di
+  tipo V, lanes parole alla volta (le parole rimanenti sono calcolate da
+  nextRowWords). I vicini a ovest e a est di ogni parola si ottengono
+  leggendo le parole adiacenti con accessi non allineati. Per TRACK, rule,
+  diff1 e diff2 vedi nextRowWords.
+*/
+template<class V, bool TRACK, class R>
+KERNEL_INLINE void nextRowVector(const R& rule,
+    const word_t* above, const word_t* row, const word_t* below,
+    unsigned int words, unsigned int lastBit, word_t* out,
+    unsigned int begin, unsigned int end, word_t* diff1, word_t* diff2) {
+  const unsigned int lanes = sizeof(V) / sizeof(word_t);
+  const unsigned int hi = WORD_BITS - 1;
+  unsigned int w = begin;
+  for(; w + lanes <= end; w += lanes) {
+    V a, aP, aN, c, cP, cN, b, bP, bN;
+    memcpy(&a, above+w, sizeof(V));
+    memcpy(&aP, above+w-1, sizeof(V));
+    memcpy(&aN, above+w+1, sizeof(V));
+    memcpy(&c, row+w, sizeof(V));
+    memcpy(&cP, row+w-1, sizeof(V));
+    memcpy(&cN, row+w+1, sizeof(V));
+    memcpy(&b, below+w, sizeof(V));
+    memcpy(&bP, below+w-1, sizeof(V));
+    memcpy(&bN, below+w+1, sizeof(V));
+    V next;
+    nextWord<R, V>(rule,
+                   (a << 1) | (aP >> hi), a, (a >> 1) | (aN << hi),
+                   (c << 1) | (cP >> hi), c, (c >> 1) | (cN << hi),
+                   (b << 1) | (bP >> hi), b, (b >> 1) | (bN << hi), next);
+    if(w + lanes == words) next[lanes-1] &= lowMask(lastBit+1);
+    if(TRACK) {
+      V old, d1, d2;
+      memcpy(&old, out+w, sizeof(V));
+      memcpy(&d1, diff1+w, sizeof(V));
+      memcpy(&d2, diff2+w, sizeof(V));
+      // Le colonne fantasma dell'ultima parola non sono cambiamenti
+      if(w + lanes == words) {
+        c[lanes-1] &= lowMask(lastBit+1);
+        old[lanes-1] &= lowMask(lastBit+1);
+      }
+      d1 |= next ^ c;
+      d2 |= next ^ old;
+      memcpy(diff1+w, &d1, sizeof(V));
+      memcpy(diff2+w, &d2, sizeof(V));
+    }
+    memcpy(out+w, &next, sizeof(V));
+  } // end for w
+  nextRowWords<TRACK>(rule, above, row, below, words, lastBit, out, w, end,
+      diff1, diff2);
+  return;
+} // end of function nextRowVector
+
+template<bool TRACK, class R>
+__attribute__((target("sse2")))
+inline void nextRowSse2(const R& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end,
+    word_t* diff1, word_t* diff2) {
+  nextRowVector<vec128_t, TRACK>(rule, above, row, below, words, lastBit,
+      out, begin, end, diff1, diff2);
+} // end of function nextRowSse2
+
+template<bool TRACK, class R>
+__attribute__((target("avx2")))
+inline void nextRowAvx2(const R& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end,
+    word_t* diff1, word_t* diff2) {
+  nextRowVector<vec256_t, TRACK>(rule, above, row, below, words, lastBit,
+      out, begin, end, diff1, diff2);
+} // end of function nextRowAvx2
+
+template<bool TRACK, class R>
+__attribute__((target("avx512f")))
+inline void nextRowAvx512(const R& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end,
+    word_t* diff1, word_t* diff2) {
+  nextRowVector<vec512_t, TRACK>(rule, above, row, below, words, lastBit,
+      out, begin, end, diff1, diff2);
+} // end of function nextRowAvx512
+
+#endif // GAMEOFLIFE_X86_SIMD
+
+/*
+  Seleziona la versione del kernel per l'insieme di istruzioni restituito
+  da activeIsa.
+*/
+template<bool TRACK, class R>
+inline void nextRowIsa(const R& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end,
+    word_t* diff1, word_t* diff2) {
+#ifdef GAMEOFLIFE_X86_SIMD
+  switch(activeIsa()) {
+    case ISA_SSE2:
+      nextRowSse2<TRACK>(rule, above, row, below, words, lastBit, out, begin,
+          end, diff1, diff2);
+      return;
+    case ISA_AVX2:
+      nextRowAvx2<TRACK>(rule, above, row, below, words, lastBit, out, begin,
+          end, diff1, diff2);
+      return;
+    case ISA_AVX512:
+      nextRowAvx512<TRACK>(rule, above, row, below, words, lastBit, out,
+          begin, end, diff1, diff2);
+      return;
+    default:
+      break;
+  }
+#endif
+  nextRowWords<TRACK>(rule, above, row, below, words, lastBit, out, begin,
+      end, diff1, diff2);
+  return;
+} // end of function nextRowIsa
+
+/*
+  Restituisce la maschera (vedi Rule) delle cifre di digits.
+*/
+constexpr unsigned int ruleMask(const char* digits) {
+  unsigned int mask = 0;
+  for(; *digits != '\0'; ++digits) mask |= 1u << (*digits - '0');
+  return mask;
+} // end of function ruleMask
+
+/*
+  Se rule e' la regola BIRTH/SURVIVAL calcola la riga con la versione del
+  kernel specializzata per essa e restituisce true.
+*/
+template<bool TRACK, unsigned int BIRTH, unsigned int SURVIVAL>
+KERNEL_INLINE bool nextRowFixed(const Rule& rule, const word_t* above,
+    const word_t* row, const word_t* below, unsigned int words,
+    unsigned int lastBit, word_t* out, unsigned int begin, unsigned int end,
+    word_t* diff1, word_t* diff2) {
+  if(rule.birth != BIRTH || rule.survival != SURVIVAL) return false;
+  nextRowIsa<TRACK>(FixedRule<BIRTH, SURVIVAL>(), above, row, below, words,
+      lastBit, out, begin, end, diff1, diff2);
+  return true;
+} // end of function nextRowFixed
+
+/*
+  Seleziona la versione del kernel per la regola restituita da activeRule:
+  le regole piu' comuni hanno una versione specializzata (FixedRule), le
+  altre usano AnyRule.
+*/
+template<bool TRACK>
+inline void nextRowRule(const word_t* above, const word_t* row,
+    const word_t* below, unsigned int words, unsigned int lastBit,
+    word_t* out, unsigned int begin, unsigned int end, word_t* diff1,
+    word_t* diff2) {
+  const Rule& rule = activeRule();
+#define GAMEOFLIFE_FIXED_RULE(B, S) \
+  if(nextRowFixed<TRACK, ruleMask(B), ruleMask(S)>(rule, above, row, below, \
+      words, lastBit, out, begin, end, diff1, diff2)) return;
+  GAMEOFLIFE_FIXED_RULE("3", "23")               // Conway
+  GAMEOFLIFE_FIXED_RULE("36", "23")              // HighLife
+  GAMEOFLIFE_FIXED_RULE("3678", "34678")         // Day & Night
+  GAMEOFLIFE_FIXED_RULE("2", "")                 // Seeds
+  GAMEOFLIFE_FIXED_RULE("3", "012345678")        // Life without Death
+  GAMEOFLIFE_FIXED_RULE("3", "12345")            // Maze
+  GAMEOFLIFE_FIXED_RULE("1357", "1357")          // Replicator
+  GAMEOFLIFE_FIXED_RULE("36", "125")             // 2x2
+  GAMEOFLIFE_FIXED_RULE("368", "245")            // Morley
+  GAMEOFLIFE_FIXED_RULE("35678", "5678")         // Diamoeba
+  GAMEOFLIFE_FIXED_RULE("4678", "35678")         // Anneal
+#undef GAMEOFLIFE_FIXED_RULE
+  nextRowIsa<TRACK>(AnyRule(rule), above, row, below, words, lastBit, out,
+      begin, end, diff1, diff2);
+  return;
+} // end of function nextRowRule
+
+/**
+ * Calcola le parole da begin a end-1 della generazione successiva di una
+ * riga di celle (vedi nextRowRange) con la regola restituita da activeRule
+ * e l'insieme di istruzioni restituito da activeIsa. Se begin e end non
+ * sono indicati calcola tutta la riga.
+ */
+inline void nextRow(const word_t* above, const word_t* row,
+    const word_t* below, unsigned int words, unsigned int lastBit,
+    word_t* out, unsigned int begin = 0, unsigned int end = ~0u) {
+  if(end > words) end = words;
+  nextRowRule<false>(above, row, below, words, lastBit, out, begin, end,
+      NULL, NULL);
+  return;
+} // end of function nextRow
+
+/**
+ * Come nextRow, ma nella stessa passata accumula (in OR) in diff1 le
+ * differenze di ogni parola calcolata dalla riga corrente (row) e in diff2
+ * quelle dal contenuto che aveva out prima di essere sovrascritto.
+ */
+inline void nextRowTracked(const word_t* above, const word_t* row,
+    const word_t* below, unsigned int words, unsigned int lastBit,
+    word_t* out, unsigned int begin, unsigned int end, word_t* diff1,
+    word_t* diff2) {
+  if(end > words) end = words;
+  nextRowRule<true>(above, row, below, words, lastBit, out, begin, end,
+      diff1, diff2);
+  return;
+} // end of function nextRowTracked
+
+} // end of namespace gameoflife
+
+
+#endif // _SIMD_H
@@ -0,0 +1,238 @@
+/*!
+  \file Slice.h
+  \brief Implementazione della classe gameoflife::Slice
+  \date 17-10-2026
+*/
+
+#ifndef _SLICE_H
+#define _SLICE_H 1
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "Bits.h"
+#include "Numa.h"
+
+
+namespace gameoflife {
+
+//! Dimensione in byte di una linea di cache.
+const unsigned int CACHE_LINE = 64;
+
+//! Numero di parole in una linea di cache.
+const unsigned int LINE_WORDS = CACHE_LINE / sizeof(word_t);
+
+/**
+ * Restituisce il numero di righe delle fasce in cui threads thread si
+ * dividono rows righe: le fasce iniziano ogni WORD_BITS righe, per cui le
+ * celle di una colonna di fasce diverse si trovano in parole diverse di un
+ * vettore (vedi Block::getLeftBoundary). Il thread t calcola le righe da
+ * t*bandRows() in poi, e alcuni thread possono restare senza righe.
+ */
+inline unsigned int bandRows(unsigned int rows, unsigned int threads) {
+  unsigned int band = (rows + threads - 1) / threads;
+  return (band + WORD_BITS - 1) / WORD_BITS * WORD_BITS;
+} // end of function bandRows
+
+/*!
+  \class Slice
+  \brief Matrice di celle circondata da una cornice di celle fantasma.
+
+  Memorizza le celle di un blocco in un unico buffer contiguo, allineato alla
+  linea di cache, in forma compatta (un bit per cella). Attorno alle _rows x
+  _cols celle interne si trova una cornice fantasma, di una riga sopra e
+  sotto e di _ghost colonne per lato, che contiene le celle dei vicini (le
+  righe di un blocco sono sempre complete, per cui una sola riga fantasma
+  basta per qualsiasi _ghost): in questo modo ogni cella
+  interna legge i propri vicini con gli stessi spostamenti, senza casi
+  particolari ai bordi.
+
+  Ogni riga occupa _stride parole (multiplo della linea di cache): _pad
+  parole a sinistra, le cui celle piu' a destra sono le colonne fantasma di
+  sinistra, seguite dalle parole delle celle interne, a cui seguono le
+  colonne fantasma di destra. La cella (i,j) si trova quindi nel bit j a
+  partire da row(i), anche per j negativo (colonne fantasma di sinistra) o
+  maggiore o uguale a _cols (colonne fantasma di destra). Prima e dopo le
+  parole delle colonne fantasma c'e' sempre almeno un'altra parola, per cui
+  i kernel possono leggere la parola precedente e la successiva di ognuna.
+*/
+class Slice {
+
+  // PRIVATE MEMBERS
+  private:
+
+    unsigned int _rows;   // numero di righe interne
+    unsigned int _cols;   // numero di colonne interne
+    unsigned int _ghost;  // colonne fantasma per lato
+    unsigned int _words;  // parole delle celle interne di una riga
+    unsigned int _pad;    // parole a sinistra delle celle interne
+    unsigned int _stride; // parole per riga
+
+    word_t* _buffer;      // _buffer[(_rows + 2) * _stride]
+
+    /*
+      Restituisce in first e last (escluso) le righe della fascia t, di
+      band righe: la riga fantasma di sopra appartiene alla prima fascia e
+      quella di sotto all'ultima. Restituisce false se la fascia non ha
+      righe.
+    */
+    bool bandRange(unsigned int t, unsigned int band, int& first,
+        int& last) const {
+      if(t * band >= _rows) return false;
+      first = (t == 0 ? -1 : (int)(t * band));
+      last = (int)std::min((t + 1) * band, _rows);
+      if(last == (int)_rows) last++;
+      return true;
+    } // end of method bandRange
+
+    // La copia non e' consentita
+    Slice(const Slice&);
+    Slice& operator=(const Slice&);
+
+  // PUBLIC METHODS
+  public:
+
+    /**
+     * Costruisce una matrice di rows x cols celle morte, con una riga
+     * fantasma sopra e sotto e ghost colonne fantasma per lato. Le righe
+     * vengono azzerate da threads thread, ognuno la propria fascia (vedi
+     * bandRows): cosi' le pagine di ogni fascia vengono allocate vicino al
+     * thread che la calcolera', e poi posizionate con la politica
+     * restituita da activeNumaPolicy.
+     */
+    Slice(unsigned int rows, unsigned int cols, unsigned int ghost = 1,
+        unsigned int threads = 1) :
+        _rows(rows), _cols(cols), _ghost(ghost), _words(wordsFor(cols)) {
+      _pad = (wordsFor(_ghost) + LINE_WORDS) / LINE_WORDS * LINE_WORDS;
+      unsigned int used = _pad + _words + wordsFor(_ghost) + 1;
+      _stride = (used + LINE_WORDS - 1) / LINE_WORDS * LINE_WORDS;
+      size_t size = sizeof(word_t) * _stride * (_rows + 2);
+      void* buffer = NULL;
+      if(posix_memalign(&buffer, CACHE_LINE, size) != 0)
+        throw std::bad_alloc();
+      _buffer = (word_t*) buffer;
+      unsigned int band = bandRows(_rows, threads);
+      #pragma omp parallel for num_threads(threads) schedule(static, 1)
+      for(unsigned int t=0; t < threads; ++t) {
+        int first, last;
+        if(bandRange(t, band, first, last)) {
+          size_t bytes = sizeof(word_t) * _stride * (last - first);
+          memset(row(first) - _pad, 0, bytes);
+          applyNumaPolicy(row(first) - _pad, bytes, activeNumaPolicy());
+        }
+      } // end for t
+      return;
+    } // end of constructor
+
+    /**
+     * Distruttore
+     */
+    ~Slice() {
+      free(_buffer);
+    } // end of destructor
+
+    /**
+     * Restituisce il numero di righe interne.
+     */
+    unsigned int getRows() const {
+      return _rows;
+    } // end of method getRows
+
+    /**
+     * Restituisce il numero di colonne interne.
+     */
+    unsigned int getColumns() const {
+      return _cols;
+    } // end of method getColumns
+
+    /**
+     * Restituisce il numero di colonne fantasma per lato.
+     */
+    unsigned int getGhost() const {
+      return _ghost;
+    } // end of method getGhost
+
+    /**
+     * Restituisce il numero di parole che contengono le celle interne di una
+     * riga.
+     */
+    unsigned int getWords() const {
+      return _words;
+    } // end of method getWords
+
+    /**
+     * Restituisce il puntatore alla parola che contiene la cella (i,0), con
+     * i compreso tra -1 e rows.
+     */
+    word_t* row(int i) {
+      return _buffer + (i + 1) * _stride + _pad;
+    } // end of method row
+
+    /**
+     * Restituisce il puntatore alla parola che contiene la cella (i,0), con
+     * i compreso tra -1 e rows.
+     */
+    const word_t* row(int i) const {
+      return _buffer + (i + 1) * _stride + _pad;
+    } // end of method row
+
+    /**
+     * Restituisce la cella (i,j), con i e j che possono indicare anche una
+     * cella della cornice fantasma.
+     */
+    bool get(int i, int j) const {
+      return getBit(row(i) - _pad, _pad*WORD_BITS + j);
+    } // end of method get
+
+    /**
+     * Imposta la cella (i,j), con i e j che possono indicare anche una
+     * cella della cornice fantasma.
+     */
+    void set(int i, int j, bool value) {
+      setBit(row(i) - _pad, _pad*WORD_BITS + j, value);
+      return;
+    } // end of method set
+
+    /**
+     * Azzera le celle interne della riga i.
+     */
+    void clearRow(int i) {
+      memset(row(i), 0, sizeof(word_t)*_words);
+      return;
+    } // end of method clearRow
+
+    /**
+     * Copia in questa matrice tutte le celle di s, con le stesse dimensioni,
+     * dividendo le righe tra threads thread come il costruttore.
+     */
+    void copyFrom(const Slice& s, unsigned int threads) {
+      unsigned int band = bandRows(_rows, threads);
+      #pragma omp parallel for num_threads(threads) schedule(static, 1)
+      for(unsigned int t=0; t < threads; ++t) {
+        int first, last;
+        if(bandRange(t, band, first, last))
+          memcpy(row(first) - _pad, s.row(first) - _pad, sizeof(word_t) *
+              _stride * (last - first));
+      } // end for t
+      return;
+    } // end of method copyFrom
+
+    /**
+     * Copia nelle righe fantasma le righe interne all'estremo opposto, per
+     * realizzare la chiusura toroidale della matrice sulle righe. Le righe
+     * vengono copiate per intero, comprese le colonne fantasma.
+     */
+    void wrapRows() {
+      size_t size = sizeof(word_t) * _stride;
+      memcpy(row(-1) - _pad, row(_rows - 1) - _pad, size);
+      memcpy(row(_rows) - _pad, row(0) - _pad, size);
+      return;
+    } // end of method wrapRows
+
+}; // end of class Slice
+
+} // end of namespace gameoflife
+
+
+#endif // _SLICE_H
@@ -0,0 +1,133 @@
+/*!
+  \file Sparse.h
+  \brief Calcolo della generazione successiva a partire dalle sole celle vive
+  \date 18-10-2026
+*/
+
+#ifndef _SPARSE_H
+#define _SPARSE_H 1
+
+#include <algorithm>
+#include <vector>
+#include "Bits.h"
+#include "Kernel.h"
+#include "Slice.h"
+
+
+namespace gameoflife {
+
+/*!
+  \struct LiveCells
+  \brief Elenco ordinato delle celle vive di una matrice.
+
+  Le colonne delle celle vive della riga i si trovano, in ordine crescente,
+  in cols da start[i] a start[i+1]-1.
+*/
+struct LiveCells {
+
+  std::vector<unsigned int> start; // start[rows+1]
+  std::vector<unsigned int> cols;  // colonne delle celle vive
+
+  /**
+   * Restituisce il numero di celle vive.
+   */
+  unsigned int size() const {
+    return cols.size();
+  } // end of method size
+
+  /**
+   * Costruisce l'elenco delle celle vive interne della matrice s.
+   */
+  void assign(const Slice& s) {
+    unsigned int rows = s.getRows();
+    unsigned int words = s.getWords();
+    start.resize(rows + 1);
+    cols.clear();
+    for(unsigned int i=0; i < rows; ++i) {
+      start[i] = cols.size();
+      const word_t* row = s.row(i);
+      for(unsigned int w=0; w < words; ++w) {
+        word_t bits = row[w];
+        // L'ultima parola puo' contenere la colonna fantasma di destra
+        if(w+1 == words) bits &= lowMask((s.getColumns()-1) % WORD_BITS + 1);
+        for(; bits != 0; bits &= bits - 1)
+          cols.push_back(w*WORD_BITS + __builtin_ctzll(bits));
+      } // end for w
+    } // end for i
+    start[rows] = cols.size();
+    return;
+  } // end of method assign
+
+}; // end of struct LiveCells
+
+//! Valore aggiunto da nextLiveCells al conteggio di una cella viva.
+const unsigned char ALIVE = 16;
+
+/**
+ * Restituisce true se nextLiveCells puo' calcolare la regola rule, cioe' se
+ * con essa non nascono celle senza vicini vivi (B0): in quel caso anche le
+ * celle lontane da quelle vive possono cambiare.
+ */
+inline bool sparseSupported(const Rule& rule) {
+  return (rule.birth & 1) == 0;
+} // end of function sparseSupported
+
+/**
+ * Calcola in next le celle vive della generazione successiva di s con la
+ * regola rule (senza B0, vedi sparseSupported), dove le celle vive interne
+ * di s sono live, contando i vicini solo attorno alle celle vive. Le righe
+ * si chiudono in modo toroidale e le colonne fantasma di s (una per lato)
+ * contribuiscono ai vicini delle colonne di bordo. counts e touched sono
+ * aree di lavoro: counts deve contenere getColumns() zeri, e viene
+ * restituito azzerato.
+ */
+inline void nextLiveCells(const Slice& s, const LiveCells& live,
+    LiveCells& next, std::vector<unsigned char>& counts,
+    std::vector<unsigned int>& touched, const Rule& rule) {
+  int rows = s.getRows();
+  int cols = s.getColumns();
+  next.start.resize(rows + 1);
+  next.cols.clear();
+  for(int i=0; i < rows; ++i) {
+    next.start[i] = next.cols.size();
+    touched.clear();
+    for(int di=-1; di <= 1; ++di) {
+      int r = (i + di + rows) % rows;
+      // Celle vive della riga r, comprese quelle delle colonne fantasma
+      int first = live.start[r], last = live.start[r+1];
+      for(int k = first - 1; k <= last; ++k) {
+        int j;
+        if(k < first) {
+          if(!s.get(r, -1)) continue;
+          j = -1;
+        }
+        else if(k == last) {
+          if(!s.get(r, cols)) continue;
+          j = cols;
+        }
+        else j = live.cols[k];
+        for(int c = j-1; c <= j+1; ++c) {
+          if(c < 0 || c >= cols) continue;
+          if(counts[c] == 0) touched.push_back(c);
+          // La cella stessa vale ALIVE: cosi' anche una cella viva senza
+          // vicini vivi viene considerata (per le regole S0)
+          counts[c] += (di == 0 && c == j ? ALIVE : 1);
+        } // end for c
+      } // end for k
+    } // end for di
+    std::sort(touched.begin(), touched.end());
+    for(unsigned int k=0; k < touched.size(); ++k) {
+      unsigned int c = touched[k];
+      if(rule.next(counts[c] >= ALIVE, counts[c] % ALIVE))
+        next.cols.push_back(c);
+      counts[c] = 0;
+    } // end for k
+  } // end for i
+  next.start[rows] = next.cols.size();
+  return;
+} // end of function nextLiveCells
+
+} // end of namespace gameoflife
+
+
+#endif // _SPARSE_H
@@ -0,0 +1,155 @@
+/*!
+  \file Stats.h
+  \brief Statistiche di una generazione: popolazione, nascite, morti
+  \date 18-10-2026
+*/
+
+#ifndef _STATS_H
+#define _STATS_H 1
+
+#include <algorithm>
+#include <climits>
+#include "Bits.h"
+#include "Simd.h"
+
+
+namespace gameoflife {
+
+/*
+  Conta in counts le celle vive di next, quelle nate e quelle cambiate
+  rispetto a prev, nelle parole da begin a end-1 (l'ultima riga termina con
+  la parola last, di cui contano solo le colonne fino a cols-1).
+*/
+KERNEL_INLINE void countWords(const word_t* prev, const word_t* next,
+    unsigned int begin, unsigned int end, unsigned int last,
+    unsigned int cols, unsigned long* counts) {
+  unsigned long population = 0, births = 0, changes = 0;
+  for(unsigned int w=begin; w < end; ++w) {
+    word_t n = next[w], p = prev[w];
+    if(w == last) {
+      word_t mask = lowMask((cols-1) % WORD_BITS + 1);
+      n &= mask;
+      p &= mask;
+    }
+    population += __builtin_popcountll(n);
+    births += __builtin_popcountll(n & ~p);
+    changes += __builtin_popcountll(n ^ p);
+  } // end for w
+  counts[0] = population;
+  counts[1] = births;
+  counts[2] = changes;
+  return;
+} // end of function countWords
+
+#ifdef GAMEOFLIFE_X86_SIMD
+/*
+  countWords con l'istruzione popcnt.
+*/
+__attribute__((target("popcnt")))
+inline void countWordsPopcnt(const word_t* prev, const word_t* next,
+    unsigned int begin, unsigned int end, unsigned int last,
+    unsigned int cols, unsigned long* counts) {
+  countWords(prev, next, begin, end, last, cols, counts);
+} // end of function countWordsPopcnt
+#endif // GAMEOFLIFE_X86_SIMD
+
+/*!
+  \struct Stats
+  \brief Statistiche di una generazione rispetto alla precedente.
+
+  Contiene la popolazione, le celle nate e quelle morte, e il rettangolo che
+  racchiude le celle vive (con top > bottom se non ce ne sono, e in tal caso
+  bottom e right valgono -1). Le statistiche di piu' blocchi si combinano
+  sommando i contatori e prendendo il minimo di top e left e il massimo di
+  bottom e right.
+*/
+struct Stats {
+
+  unsigned long population;
+  unsigned long births;
+  unsigned long deaths;
+  int top, left, bottom, right; // rettangolo delle celle vive
+
+  /**
+   * Azzera i contatori e svuota il rettangolo.
+   */
+  void clear() {
+    population = births = deaths = 0;
+    top = left = INT_MAX;
+    bottom = right = -1;
+    return;
+  } // end of method clear
+
+  /**
+   * Aggiunge le parole da begin a end-1 della riga i, che era prev nella
+   * generazione precedente ed e' next in quella corrente. Le colonne da
+   * cols in poi vengono ignorate, e la colonna j della riga e' la colonna
+   * pos+j della matrice.
+   */
+  void addWords(int i, const word_t* prev, const word_t* next,
+      unsigned int begin, unsigned int end, unsigned int cols, int pos) {
+    unsigned int last = (cols - 1) / WORD_BITS;
+    if(end > last + 1) end = last + 1;
+    if(begin >= end) return;
+    unsigned long counts[3] = { 0, 0, 0 };
+#ifdef GAMEOFLIFE_X86_SIMD
+    static bool popcnt = __builtin_cpu_supports("popcnt");
+    if(popcnt) countWordsPopcnt(prev, next, begin, end, last, cols, counts);
+    else
+#endif
+    countWords(prev, next, begin, end, last, cols, counts);
+    population += counts[0];
+    births += counts[1];
+    deaths += counts[2] - counts[1];
+    if(counts[0] == 0) return;
+    // Prima e ultima parola con celle vive (l'ultima e' gia' mascherata)
+    unsigned int first = begin, final = end - 1;
+    while(next[first] == 0) first++;
+    word_t bits = next[final] &
+        (final == last ? lowMask((cols-1) % WORD_BITS + 1) : ~word_t(0));
+    while(bits == 0) bits = next[--final];
+    int j = pos + first*WORD_BITS + __builtin_ctzll(next[first]);
+    if(j < left) left = j;
+    j = pos + final*WORD_BITS + WORD_BITS - 1 - __builtin_clzll(bits);
+    if(j > right) right = j;
+    if(i < top) top = i;
+    if(i > bottom) bottom = i;
+    return;
+  } // end of method addWords
+
+  /**
+   * Aggiunge le statistiche stats, di un'altra parte della matrice.
+   */
+  void add(const Stats& stats) {
+    population += stats.population;
+    births += stats.births;
+    deaths += stats.deaths;
+    top = std::min(top, stats.top);
+    left = std::min(left, stats.left);
+    bottom = std::max(bottom, stats.bottom);
+    right = std::max(right, stats.right);
+    return;
+  } // end of method add
+
+  /**
+   * Aggiunge la cella i,j (colonna della matrice), viva nella generazione
+   * corrente se alive e in quella precedente se was.
+   */
+  void addCell(int i, int j, bool was, bool alive) {
+    births += (alive && !was);
+    deaths += (was && !alive);
+    if(!alive) return;
+    population++;
+    if(j < left) left = j;
+    if(j > right) right = j;
+    if(i < top) top = i;
+    if(i > bottom) bottom = i;
+    return;
+  } // end of method addCell
+
+}; // end of struct Stats
+
+} // end of namespace gameoflife
+
+
+#endif // _STATS_H
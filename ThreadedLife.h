@@ -0,0 +1,516 @@
+/*!
+  \file ThreadedLife.h
+  \brief Calcolo delle generazioni in un solo processo con piu' thread
+  \date 18-10-2026
+*/
+
+#ifndef _THREADED_LIFE_H
+#define _THREADED_LIFE_H 1
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Bits.h"
+#include "Matrix.h"
+#include "Numa.h"
+#include "Simd.h"
+
+
+namespace gameoflife {
+
+//! Righe delle tessere in cui ThreadedLife divide la matrice.
+const unsigned int TASK_ROWS = 64;
+
+//! Parole per riga delle tessere in cui ThreadedLife divide la matrice.
+const unsigned int TASK_WORDS = 8;
+
+//! Generazioni di cui una tessera puo' precedere la piu' lenta (default).
+const unsigned int LAG_LIMIT = 8;
+
+/*!
+  \class ThreadedLife
+  \brief Motore bitwise a memoria condivisa, senza MPI e senza blocchi.
+
+  Calcola le generazioni direttamente sulle righe di una Matrix (che ha una
+  parola fantasma per lato, vedi Matrix::wrapRow) con un gruppo di thread,
+  senza barriere tra una generazione e l'altra. Il lavoro e' diviso in
+  tessere di TASK_ROWS righe e TASK_WORDS parole; la tessera della prima
+  colonna comprende anche le parole dell'ultima, adiacenti sul toro, per cui
+  e' l'unica a scrivere le colonne fantasma delle proprie righe.
+
+  La tessera k puo' calcolare la generazione g+1 appena lei e le sue vicine
+  (sul toro) hanno calcolato la generazione g: per ogni tessera un contatore
+  per generazione pari e uno per generazione dispari contano le vicine che
+  non l'hanno ancora fatto, e la vicina che lo porta a 0 mette la tessera
+  nella propria coda. Cosi' una tessera non precede mai le vicine di piu' di
+  una generazione, e la sua storia sono le sue celle nelle due matrici
+  (generazioni pari in quella passata ad advance, dispari nell'altra): la
+  generazione g+1 sovrascrive la g-1, che nessuna vicina legge piu'. Le zone
+  piu' veloci possono precedere le piu' lente di piu' generazioni, ma al
+  massimo di lag rispetto alla generazione gia' calcolata da tutte le
+  tessere: le tessere oltre il limite attendono in _parked.
+
+  Se nella generazione precedente nessuna tessera del vicinato di una
+  tessera (lei compresa) e' cambiata, o nessuna e' cambiata rispetto a due
+  generazioni prima (periodo 2), la seconda matrice contiene gia' le sue
+  celle e la tessera non viene calcolata. Ogni thread prende le tessere
+  dalla fine della propria coda (le ultime rese pronte, vicine a quelle
+  appena calcolate) e, quando e' vuota, le ruba dall'inizio di quelle degli
+  altri.
+
+  All'avvio ogni thread, fissato a una CPU se richiesto (setPinning),
+  sposta nella propria memoria le righe delle due matrici della fascia di
+  cui gli vengono date le tessere (vedi getBand), per cui le pagine si
+  trovano sul suo nodo NUMA (e poi vengono posizionate con la politica
+  restituita da activeNumaPolicy).
+*/
+class ThreadedLife {
+
+  // PRIVATE TYPES
+  private:
+
+    /*
+      Coda delle tessere pronte di un thread: il thread le prende dalla
+      fine, gli altri le rubano dall'inizio.
+    */
+    struct Queue {
+      std::mutex mutex;
+      std::deque<unsigned int> tiles;
+    }; // end of struct Queue
+
+  // PRIVATE MEMBERS
+  private:
+
+    unsigned int _threads;
+    unsigned int _lag;                 // limite di anticipo delle tessere
+    bool _pin;                         // true se i thread vanno fissati
+    unsigned int _rows, _words;        // dimensioni della matrice
+    unsigned int _tileRows, _tileCols; // tessere per colonna e per riga
+    unsigned long _generations;        // generazioni da calcolare
+    Matrix* _matrix[2];                // generazioni pari e dispari
+
+    std::vector<std::vector<unsigned int> > _neighbors; // vicinato (distinto)
+    std::vector<unsigned long> _generation;   // generazione di ogni tessera
+    std::vector<char> _changed[2];            // cambiamenti (pari, dispari)
+    std::vector<std::atomic<unsigned int> > _waiting[2]; // vicine attese
+    std::vector<Queue> _queues;               // _queues[_threads]
+    std::atomic<unsigned long> _remaining;    // tessere ancora da calcolare
+
+    std::mutex _floorMutex;
+    std::atomic<unsigned long> _floor;        // generazione di tutte
+    std::vector<std::atomic<unsigned int> > _finished; // tessere per gen.
+    std::vector<std::vector<unsigned int> > _parked;   // oltre il limite
+
+    std::vector<double> _busy;        // secondi di calcolo di ogni thread
+    std::vector<unsigned long> _tiles, _stolen; // tessere calcolate e rubate
+    std::vector<unsigned long> _maxLag; // anticipo massimo sulla piu' lenta
+
+    std::atomic<unsigned int> _placed;  // thread che hanno spostato le righe
+    std::vector<int> _cpu, _node;       // CPU e nodo di ogni thread
+    std::vector<std::string> _memory;   // nodi delle righe di ogni fascia
+
+    /*
+      Restituisce in begin e end (escluso) le parole della colonna di
+      tessere c; per la colonna 0 sono le parole iniziali, e le finali sono
+      da wrapBegin a wrapEnd (escluso).
+    */
+    void tileWords(unsigned int c, unsigned int& begin, unsigned int& end,
+        unsigned int& wrapBegin, unsigned int& wrapEnd) const {
+      begin = c * TASK_WORDS;
+      end = std::min(begin + TASK_WORDS, _words);
+      wrapBegin = wrapEnd = _words;
+      if(c == 0 && _tileCols > 1) wrapBegin = _tileCols * TASK_WORDS;
+      else if(c == 0) end = _words;
+      return;
+    } // end of method tileWords
+
+    /*
+      Restituisce true se la tessera k e' ferma nella generazione in cui i
+      cambiamenti delle tessere nella precedente sono active (vedi
+      computeTile): nel suo vicinato nessuna tessera e' cambiata, o nessuna
+      e' cambiata rispetto a due generazioni prima.
+    */
+    bool still(unsigned int k, const std::vector<char>& active) const {
+      char moving = 0;
+      for(unsigned int n=0; n < _neighbors[k].size(); ++n)
+        moving |= active[_neighbors[k][n]];
+      return moving != 3;
+    } // end of method still
+
+    /*
+      Calcola in next la tessera k della generazione successiva di current
+      e ne restituisce i cambiamenti: il bit 0 e' 1 se e' cambiata rispetto
+      a current, il bit 1 se e' cambiata rispetto al contenuto precedente di
+      next (due generazioni prima). diff1 e diff2 sono aree di lavoro di
+      _words parole.
+    */
+    char computeTile(unsigned int k, const Matrix* current, Matrix* next,
+        word_t* diff1, word_t* diff2) const {
+      unsigned int r = k / _tileCols, c = k % _tileCols;
+      unsigned int begin, end, wrapBegin, wrapEnd;
+      tileWords(c, begin, end, wrapBegin, wrapEnd);
+      unsigned int lastBit = (current->getColumns() - 1) % WORD_BITS;
+      std::fill(diff1 + begin, diff1 + end, 0);
+      std::fill(diff1 + wrapBegin, diff1 + wrapEnd, 0);
+      std::fill(diff2 + begin, diff2 + end, 0);
+      std::fill(diff2 + wrapBegin, diff2 + wrapEnd, 0);
+      unsigned int first = r * TASK_ROWS;
+      unsigned int last = std::min(first + TASK_ROWS, _rows);
+      for(unsigned int i=first; i < last; ++i) {
+        const word_t* above = current->row(i == 0 ? _rows - 1 : i - 1);
+        const word_t* row = current->row(i);
+        const word_t* below = current->row(i + 1 == _rows ? 0 : i + 1);
+        nextRowTracked(above, row, below, _words, lastBit, next->row(i),
+            begin, end, diff1, diff2);
+        if(c == 0) {
+          nextRowTracked(above, row, below, _words, lastBit, next->row(i),
+              wrapBegin, wrapEnd, diff1, diff2);
+          next->wrapRow(i);
+        }
+      } // end for i
+      word_t d1 = 0, d2 = 0;
+      for(unsigned int w=begin; w < end; ++w) {
+        d1 |= diff1[w];
+        d2 |= diff2[w];
+      }
+      for(unsigned int w=wrapBegin; w < wrapEnd; ++w) {
+        d1 |= diff1[w];
+        d2 |= diff2[w];
+      }
+      return (d1 != 0) | ((d2 != 0) << 1);
+    } // end of method computeTile
+
+    /*
+      Mette la tessera k, pronta per la generazione g, nella coda del
+      thread t, o in _parked se g supera di piu' di _lag la generazione gia'
+      calcolata da tutte le tessere.
+    */
+    void schedule(unsigned int t, unsigned int k, unsigned long g) {
+      // _floor cresce soltanto: serve il lock solo vicino al limite
+      if(g > _floor + _lag) {
+        std::lock_guard<std::mutex> lock(_floorMutex);
+        if(g > _floor + _lag) {
+          _parked[g % _parked.size()].push_back(k);
+          return;
+        }
+      }
+      std::lock_guard<std::mutex> lock(_queues[t].mutex);
+      _queues[t].tiles.push_back(k);
+      return;
+    } // end of method schedule
+
+    /*
+      Registra che il thread t ha calcolato la generazione g della tessera
+      k: se era l'ultima tessera della generazione g sveglia le tessere in
+      attesa del limite, e mette in coda le tessere del vicinato di cui k
+      era l'ultima vicina attesa per la generazione g+1.
+    */
+    void release(unsigned int t, unsigned int k, unsigned long g) {
+      unsigned int tiles = _tileRows * _tileCols;
+      std::atomic<unsigned int>& finished = _finished[g % _finished.size()];
+      if(finished.fetch_add(1) + 1 == tiles) {
+        finished = 0;
+        std::vector<unsigned int> woken;
+        {
+          std::lock_guard<std::mutex> lock(_floorMutex);
+          _floor = g;
+          woken.swap(_parked[(g + _lag) % _parked.size()]);
+        }
+        std::lock_guard<std::mutex> lock(_queues[t].mutex);
+        _queues[t].tiles.insert(_queues[t].tiles.end(), woken.begin(),
+            woken.end());
+      }
+      for(unsigned int n=0; n < _neighbors[k].size(); ++n) {
+        unsigned int j = _neighbors[k][n];
+        std::atomic<unsigned int>& waiting = _waiting[(g + 1) % 2][j];
+        if(waiting.fetch_sub(1) != 1) continue;
+        // Il contatore torna pronto per la generazione g+3
+        waiting = _neighbors[j].size();
+        if(g + 1 <= _generations) schedule(t, j, g + 1);
+      } // end for n
+      return;
+    } // end of method release
+
+    /*
+      Prende in k una tessera dalla coda del thread t o, se e' vuota, la
+      ruba da quella di un altro thread (stolen diventa true). Restituisce
+      false se tutte le code sono vuote.
+    */
+    bool take(unsigned int t, unsigned int& k, bool& stolen) {
+      for(unsigned int n=0; n < _threads; ++n) {
+        Queue& queue = _queues[(t + n) % _threads];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(queue.tiles.empty()) continue;
+        if(n == 0) {
+          k = queue.tiles.back();
+          queue.tiles.pop_back();
+        }
+        else {
+          k = queue.tiles.front();
+          queue.tiles.pop_front();
+        }
+        stolen = (n > 0);
+        return true;
+      } // end for n
+      return false;
+    } // end of method take
+
+    /*
+      Fissa il thread t alla propria CPU (se _pin) e sposta nella propria
+      memoria le righe della sua fascia nelle due matrici, applicando la
+      politica NUMA; registra la CPU, il nodo del thread e quelli delle
+      righe (al massimo 64 campioni).
+    */
+    void place(unsigned int t) {
+      _cpu[t] = (_pin ? pinThread(t) : -1);
+      _node[t] = currentNumaNode();
+      unsigned int first, last;
+      getBand(t, first, last);
+      unsigned int step = std::max((last - first) / 64, 1u);
+      std::vector<const void*> samples;
+      for(unsigned int i=first; i < last; ++i) {
+        for(unsigned int m=0; m < 2; ++m) {
+          _matrix[m]->relocateRow(i);
+          applyNumaPolicy(_matrix[m]->row(i) - 1,
+              sizeof(word_t) * (_words + 2), activeNumaPolicy());
+        }
+        if((i - first) % step == 0) samples.push_back(_matrix[0]->row(i));
+      } // end for i
+      _memory[t] = numaNodeList(samples);
+      return;
+    } // end of method place
+
+    /*
+      Corpo del thread t: dopo che tutti i thread hanno spostato le proprie
+      righe (vedi place) calcola le tessere pronte, prendendole e
+      rubandole (vedi take), finche' tutte le tessere non hanno calcolato
+      _generations generazioni.
+    */
+    void run(unsigned int t) {
+      place(t);
+      _placed++;
+      while(_placed < _threads) std::this_thread::yield();
+      std::vector<word_t> diff1(_words), diff2(_words);
+      while(_remaining > 0) {
+        unsigned int k;
+        bool stolen;
+        if(!take(t, k, stolen)) {
+          std::this_thread::yield();
+          continue;
+        }
+        unsigned long g = _generation[k] + 1;
+        _maxLag[t] = std::max(_maxLag[t], g - _floor);
+        const std::vector<char>& active = _changed[(g - 1) % 2];
+        if(still(k, active))
+          _changed[g % 2][k] = active[k] & 1;
+        else {
+          std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          // Nella generazione 1 next e' vuota e non e' la generazione -1:
+          // la tessera conta come cambiata rispetto a due generazioni prima
+          _changed[g % 2][k] = computeTile(k, _matrix[(g - 1) % 2],
+              _matrix[g % 2], &diff1[0], &diff2[0]) | (g == 1 ? 2 : 0);
+          _busy[t] += std::chrono::duration<double>(
+              std::chrono::steady_clock::now() - start).count();
+          _tiles[t]++;
+          _stolen[t] += stolen;
+        }
+        _generation[k] = g;
+        release(t, k, g);
+        _remaining--;
+      } // end while
+      return;
+    } // end of method run
+
+    /*
+      Prepara le tessere, i contatori e le code per calcolare generations
+      generazioni di m: tutte le tessere sono pronte per la generazione 1,
+      e vengono divise tra le code in tratti consecutivi.
+    */
+    void prepare(Matrix& m, Matrix& other, unsigned long generations) {
+      _rows = m.getRows();
+      _words = m.getWords();
+      _tileRows = (_rows + TASK_ROWS - 1) / TASK_ROWS;
+      // L'ultima colonna di tessere e' unita alla prima
+      _tileCols = std::max((_words + TASK_WORDS - 1) / TASK_WORDS, 2u) - 1;
+      _generations = generations;
+      _matrix[0] = &m;
+      _matrix[1] = &other;
+      unsigned int tiles = _tileRows * _tileCols;
+      _neighbors.assign(tiles, std::vector<unsigned int>());
+      for(unsigned int k=0; k < tiles; ++k) {
+        unsigned int r = k / _tileCols, c = k % _tileCols;
+        for(int dr=-1; dr <= 1; ++dr)
+          for(int dc=-1; dc <= 1; ++dc)
+            _neighbors[k].push_back((r + _tileRows + dr) % _tileRows *
+                _tileCols + (c + _tileCols + dc) % _tileCols);
+        std::sort(_neighbors[k].begin(), _neighbors[k].end());
+        _neighbors[k].erase(std::unique(_neighbors[k].begin(),
+            _neighbors[k].end()), _neighbors[k].end());
+      } // end for k
+      _generation.assign(tiles, 0);
+      _changed[0].assign(tiles, 3);
+      _changed[1].assign(tiles, 3);
+      for(unsigned int p=0; p < 2; ++p) {
+        _waiting[p] = std::vector<std::atomic<unsigned int> >(tiles);
+        for(unsigned int k=0; k < tiles; ++k)
+          _waiting[p][k] = _neighbors[k].size();
+      } // end for p
+      _queues = std::vector<Queue>(_threads);
+      for(unsigned int k=0; k < tiles; ++k)
+        _queues[(unsigned long)k * _threads / tiles].tiles.push_front(k);
+      _remaining = (unsigned long)tiles * generations;
+      _floor = 0;
+      _finished = std::vector<std::atomic<unsigned int> >(_lag + 2);
+      for(unsigned int g=0; g < _finished.size(); ++g) _finished[g] = 0;
+      _parked.assign(_lag + 2, std::vector<unsigned int>());
+      _busy.assign(_threads, 0);
+      _tiles.assign(_threads, 0);
+      _stolen.assign(_threads, 0);
+      _maxLag.assign(_threads, 0);
+      _placed = 0;
+      _cpu.assign(_threads, -1);
+      _node.assign(_threads, -1);
+      _memory.assign(_threads, std::string());
+      return;
+    } // end of method prepare
+
+  // PUBLIC METHODS
+  public:
+
+    /**
+     * Costruisce il motore con threads thread (almeno 1), in cui le tessere
+     * possono precedere di al massimo lag generazioni (almeno 1) la
+     * generazione calcolata da tutte.
+     */
+    ThreadedLife(unsigned int threads, unsigned int lag = LAG_LIMIT) :
+        _threads(std::max(threads, 1u)), _lag(std::max(lag, 1u)),
+        _pin(false), _rows(0), _words(0), _tileRows(0), _tileCols(0),
+        _generations(0) {
+      return;
+    } // end of constructor
+
+    /**
+     * Restituisce il numero di thread.
+     */
+    unsigned int getThreads() const {
+      return _threads;
+    } // end of method getThreads
+
+    /**
+     * Se pin e' true il thread t viene fissato alla t-esima CPU consentita
+     * al processo (vedi pinThread).
+     */
+    void setPinning(bool pin) {
+      _pin = pin;
+    } // end of method setPinning
+
+    /**
+     * Restituisce in first e last (escluso) le righe della fascia del
+     * thread t: all'inizio il thread riceve le tessere di queste righe
+     * (a meno di quelle delle righe di tessere condivise con i vicini).
+     */
+    void getBand(unsigned int t, unsigned int& first,
+        unsigned int& last) const {
+      first = (unsigned long)_rows * t / _threads;
+      last = (unsigned long)_rows * (t + 1) / _threads;
+      return;
+    } // end of method getBand
+
+    /**
+     * Restituisce la CPU a cui e' stato fissato il thread t nell'ultima
+     * chiamata di advance, o -1.
+     */
+    int getCpu(unsigned int t) const {
+      return _cpu[t];
+    } // end of method getCpu
+
+    /**
+     * Restituisce il nodo NUMA su cui si trovava il thread t all'avvio
+     * dell'ultima chiamata di advance, o -1 se non e' noto.
+     */
+    int getNode(unsigned int t) const {
+      return _node[t];
+    } // end of method getNode
+
+    /**
+     * Restituisce i nodi NUMA delle righe della fascia del thread t (vedi
+     * numaNodeList) all'avvio dell'ultima chiamata di advance.
+     */
+    const std::string& getMemoryNodes(unsigned int t) const {
+      return _memory[t];
+    } // end of method getMemoryNodes
+
+    /**
+     * Restituisce i secondi passati dal thread t a calcolare le tessere
+     * nell'ultima chiamata di advance.
+     */
+    double getBusy(unsigned int t) const {
+      return _busy[t];
+    } // end of method getBusy
+
+    /**
+     * Restituisce il numero di tessere calcolate dal thread t nell'ultima
+     * chiamata di advance.
+     */
+    unsigned long getTiles(unsigned int t) const {
+      return _tiles[t];
+    } // end of method getTiles
+
+    /**
+     * Restituisce il numero di tessere rubate dal thread t nell'ultima
+     * chiamata di advance.
+     */
+    unsigned long getStolen(unsigned int t) const {
+      return _stolen[t];
+    } // end of method getStolen
+
+    /**
+     * Restituisce il massimo numero di generazioni di cui, nell'ultima
+     * chiamata di advance, una tessera ha preceduto la generazione
+     * calcolata da tutte (da 1 a lag).
+     */
+    unsigned long getMaxLag() const {
+      unsigned long lag = 0;
+      for(unsigned int t=0; t < _maxLag.size(); ++t)
+        lag = std::max(lag, _maxLag[t]);
+      return lag;
+    } // end of method getMaxLag
+
+    /**
+     * Calcola in m la generazione generations-esima di m, con la regola e
+     * l'insieme di istruzioni restituiti da activeRule e activeIsa. Il
+     * thread chiamante e' il thread 0.
+     */
+    void advance(Matrix& m, unsigned long generations) {
+      Matrix other(m.getRows(), m.getColumns());
+      prepare(m, other, generations);
+      if(generations == 0) return;
+      for(unsigned int i=0; i < _rows; ++i)
+        m.wrapRow(i);
+      // Le CPU consentite vanno lette prima che un thread venga fissato
+      allowedCpus();
+      std::vector<std::thread> pool;
+      for(unsigned int t=1; t < _threads; ++t)
+        pool.push_back(std::thread(&ThreadedLife::run, this, t));
+      run(0);
+      for(unsigned int t=0; t < pool.size(); ++t)
+        pool[t].join();
+      // Con un numero dispari di generazioni il risultato e' in other
+      if(generations % 2 == 1) m.swap(other);
+      for(unsigned int i=0; i < _rows; ++i)
+        m.unwrapRow(i);
+      return;
+    } // end of method advance
+
+}; // end of class ThreadedLife
+
+} // end of namespace gameoflife
+
+
+#endif // _THREADED_LIFE_H
@@ -9,25 +9,32 @@
 #define _VECTOR_H 1
 
 #include <iostream>
+#include <cstring>
 #include "Muesli.h"
+#include "Bits.h"
 
 
 namespace gameoflife {
 
+//! Bit della dimensione serializzata di un Vector che indica un vettore
+//! con tutti gli elementi false, inviato senza elementi.
+const unsigned int EMPTY_VECTOR = 1u << 31;
+
 /*!
   \class Vector
   \brief Vettore interno ad un blocco.
 
   Rappresenta un vettore interno ad un blocco. Implementa l'interfaccia
   MSL_Serializable poiche' oggetti di questo tipo devono essere scambiati tra
-  i workers durante la fase di sincronizzazione.
+  i workers durante la fase di sincronizzazione. Gli elementi sono memorizzati
+  in forma compatta, un bit per cella (vedi Bits.h).
 */
 class Vector : public MSL_Serializable {
 
   // PRIVATE MEMBERS
   public:
     unsigned int _size; // dimensione del vettore
-    bool* _vector;      // _vector[_size]
+    word_t* _vector;    // _vector[wordsFor(_size)]
 
   // PUBLIC FUNCTIONS
   public:
@@ -36,7 +43,7 @@ class Vector : public MSL_Serializable {
      * Costruttore di default: costruisce un vettore vuoto di dimensione "size"
      */
     Vector(unsigned int size = 0) : _size(size) {
-      _vector = new bool[_size];
+      _vector = new word_t[wordsFor(_size)]();
     } // end of default constructor
     
     /**
@@ -44,9 +51,8 @@ class Vector : public MSL_Serializable {
      */
     Vector(const Vector& vector) {
       _size = vector.getVectorSize();
-      _vector = new bool[_size];
-      for(int i=0; i < _size; ++i)
-        _vector[i] = vector.get(i);
+      _vector = new word_t[wordsFor(_size)];
+      memcpy(_vector, vector._vector, wordsFor(_size)*sizeof(word_t));
     } // end of copy constructor
 
     /**
@@ -60,36 +66,46 @@ class Vector : public MSL_Serializable {
      * Operatore di assegnamento
      */
     Vector& operator=(const Vector& vector) {
+      if(this == &vector) return (*this);
       _size = vector.getVectorSize();
       delete[] _vector;
-      _vector = new bool[_size];
-      for(int i=0; i < _size; ++i)
-        _vector[i] = vector.get(i);
+      _vector = new word_t[wordsFor(_size)];
+      memcpy(_vector, vector._vector, wordsFor(_size)*sizeof(word_t));
       return (*this);
     } // end of operator=
     
     /**
      * Restituisce l'i-esimo elemento
      */
-    bool& get(unsigned int i) {
-      return _vector[i];
-    } // end of method get
-
-    /**
-     * Restituisce l'i-esimo elemento
-     */
-    const bool& get(unsigned int i) const {
-      return _vector[i];
+    bool get(unsigned int i) const {
+      return getBit(_vector, i);
     } // end of method get
     
     /**
      * Imposta l'i-esimo elemento
      */
     void set(unsigned int i, bool value) {
-      _vector[i] = value;
+      setBit(_vector, i, value);
       return;
     } // end of method set
     
+    /**
+     * Imposta tutti gli elementi a false.
+     */
+    void clear() {
+      memset(_vector, 0, wordsFor(_size)*sizeof(word_t));
+      return;
+    } // end of method clear
+
+    /**
+     * Restituisce true se tutti gli elementi sono false.
+     */
+    bool isEmpty() const {
+      for(unsigned int w=0; w < wordsFor(_size); ++w)
+        if(_vector[w] != 0) return false;
+      return true;
+    } // end of method isEmpty
+
     /**
      * Restituisce la dimensione del vettore.
      */
@@ -97,30 +113,37 @@ class Vector : public MSL_Serializable {
       return _size;
     } // end of method getVectorSize()
 
-    /** Override */
+    /**
+     * Override. Un vettore vuoto (vedi isEmpty) viene serializzato senza
+     * elementi, con EMPTY_VECTOR nella dimensione.
+     */
     inline int getSize() {
       return sizeof(unsigned int) +  // _size
-          sizeof(bool) * _size;      // _vector
+          (isEmpty() ? 0 : sizeof(word_t) * wordsFor(_size)); // _vector
     } // end of method getSize
 
     /** Override */
     void reduce(void* pBuffer, int bufferSize) {
       typedef unsigned int uint;
-      uint* adr = (uint*) memcpy(pBuffer, &_size, sizeof(uint));
+      bool empty = isEmpty();
+      uint size = (empty ? _size | EMPTY_VECTOR : _size);
+      uint* adr = (uint*) memcpy(pBuffer, &size, sizeof(uint));
       adr++;
-      memcpy(adr, _vector, _size*sizeof(bool));
+      if(!empty) memcpy(adr, _vector, wordsFor(_size)*sizeof(word_t));
       return;
     } // end of method reduce
 
     /** Override */
     void expand(void* pBuffer, int bufferSize) {
-      int* adr1 = (int*) pBuffer;
-      _size = *(adr1++);
-      bool* adr2 = (bool*) adr1;
-      delete[] _vector;
-      _vector = new bool[_size];
-      for(int i=0; i < _size; ++i)
-        _vector[i] = *(adr2++);
+      unsigned int* adr1 = (unsigned int*) pBuffer;
+      unsigned int size = *(adr1++);
+      if(wordsFor(size & ~EMPTY_VECTOR) != wordsFor(_size)) {
+        delete[] _vector;
+        _vector = new word_t[wordsFor(size & ~EMPTY_VECTOR)];
+      }
+      _size = size & ~EMPTY_VECTOR;
+      if(size & EMPTY_VECTOR) clear();
+      else memcpy(_vector, adr1, wordsFor(_size)*sizeof(word_t));
       return;
     } // end of method expand
 
@@ -6,16 +6,32 @@
 */
 
 #include <iostream>
+#include <fstream>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include <getopt.h>
 #include <sys/time.h>
 #include "Muesli.h"
 #include "Matrix.h"
 #include "Block.h"
 #include "Vector.h"
+#include "Kernel.h"
+#include "Simd.h"
+#include "HashLife.h"
+#include "LargerThanLife.h"
+#include "Stats.h"
+#include "ThreadedLife.h"
+#include "Numa.h"
 
 using gameoflife::Matrix;
 using gameoflife::Block;
 using gameoflife::Vector;
+using gameoflife::Engine;
+using gameoflife::Isa;
 
 
 // Matrice che rappresenta il "Gioco della vita"
@@ -26,8 +42,57 @@ unsigned int COLUMNS;
 // Densita' della matrice
 float DENSITY;
 
+// Seme del generatore casuale utilizzato per popolare la matrice
+unsigned int SEED;
+
 // Numero di iterazioni
-unsigned int ITERATIONS;
+unsigned long ITERATIONS;
+
+// Motore utilizzato dai workers per calcolare le generazioni
+Engine ENGINE;
+
+// Insieme di istruzioni vettoriali utilizzato dal motore bitwise
+Isa ISA;
+
+// Regola del gioco (B3/S23 per il gioco della vita di Conway)
+gameoflife::Rule RULE;
+
+// Regola Larger than Life (raggio 0 se la regola e' RULE)
+gameoflife::LtlRule LTL_RULE;
+
+// Larghezza in parole delle strisce di colonne del motore bitwise (0 per
+// percorrere i blocchi a righe intere)
+unsigned int STRIP_WORDS;
+
+// Thread di ogni worker (motore bitwise)
+unsigned int THREADS;
+
+// Thread del processo nella modalita' a memoria condivisa, senza MPI (0 per
+// usare la farm)
+unsigned int SHARED_THREADS;
+
+// Generazioni di cui, nella modalita' a memoria condivisa, una tessera puo'
+// precedere quella piu' indietro
+unsigned int LAG;
+
+// Politica con cui vengono posizionate sui nodi NUMA le fasce di righe dei
+// thread
+gameoflife::NumaPolicy NUMA_POLICY;
+
+// True se i thread devono essere fissati alle CPU
+bool PIN_THREADS;
+
+// True se all'avvio deve essere stampato su quali nodi NUMA si trovano le
+// fasce di righe dei thread (con --numa o --pin)
+bool NUMA_REPORT;
+
+// Colonne fantasma per lato dei blocchi: i workers si sincronizzano ogni
+// DEPTH generazioni
+unsigned int DEPTH;
+
+// True se le DEPTH generazioni tra due sincronizzazioni devono essere
+// calcolate una tessera alla volta (tassellazione temporale)
+bool TEMPORAL;
 
 // True se si deve stampare la matrice iniziale e finale
 bool PRINT_MATRIX;
@@ -35,6 +100,29 @@ bool PRINT_MATRIX;
 // True se devono essere stampati i tempi di computazione
 bool PRINT_CTIMES;
 
+// True se si deve eseguire il benchmark dei motori
+bool BENCHMARK;
+
+// True se la matrice finale deve essere calcolata con HashLife
+bool HASHLIFE;
+
+// Memoria massima (in megabyte) dei nodi di HashLife
+unsigned long HASHLIFE_MB;
+
+// File in cui scrivere le statistiche di ogni generazione (NULL per non
+// calcolarle)
+const char* STATS_FILE;
+
+// Generazioni tra due riduzioni delle statistiche dei workers
+unsigned long STATS_EVERY;
+
+// True se i workers devono cercare un ciclo della matrice per saltare alla
+// generazione ITERATIONS
+bool CYCLES;
+
+// Numero di hash della matrice ricordati per la ricerca dei cicli
+const unsigned int CYCLE_HISTORY = 64;
+
 // MPI workers comunicator
 MPI_Comm MPI_COMM_WORKERS;
 
@@ -46,6 +134,10 @@ int* WORKERS_ID;
 timeval T_START, T_END;
 clock_t C_START, C_END;
 
+// Matrici di celle allocate dal blocco durante le iterazioni (-1 se il
+// processo non e' un worker)
+long SLICE_ALLOCATIONS = -1;
+
 // Dichiarazioni delle funzioni
 Block* init(Empty);
 Block* compute(Block*);
@@ -54,9 +146,24 @@ void initWorkers();
 void createMpiCommWorkes();
 void discoverNeighbors(unsigned int, ProcessorNo*, ProcessorNo*);
 void workersSynch(Block*, ProcessorNo, ProcessorNo);
+void selfSynch(Block*);
+void pinWorker(std::vector<int>&, std::vector<int>&);
+void reportWorker(Block*, const std::vector<int>&, const std::vector<int>&);
+std::string placement(const char*, unsigned int, unsigned int, unsigned int,
+    int, int, const std::string&);
+void reduceStats(std::vector<gameoflife::Stats>&, unsigned long,
+    std::ostream*);
+unsigned long findCycle(Block*, unsigned long,
+    std::vector<std::pair<unsigned long, uint64_t> >&);
+void runBenchmark();
+void runHashLife();
+bool sharedRequested(int, char**);
+void runShared();
 inline void startTimer();
 inline void stopTimer();
 bool getParameters(int, char**);
+unsigned int haloColumns();
+std::string ruleName();
 void printProgramInfo();
 void printComputationTimes();
 void printHelp();
@@ -69,7 +176,8 @@ void printHelp();
   \return 0: ok
   \return 1: errore
 
-  Esegue i seguenti passi:
+  Con l'opzione --threads esegue tutto il calcolo in un solo processo, senza
+  inizializzare MPI (vedi runShared). Altrimenti esegue i seguenti passi:
     - Inizializza gli skeleton della libreria Muesli.
     - Legge ed inizializza i parametri dell'applicazione.
     - Cotruisce la farm utilizzando la libreria Muesli.
@@ -79,6 +187,16 @@ void printHelp();
 */
 int main(int argc, char* argv[]) {
   try {
+    // Modalita' a memoria condivisa: un solo processo, senza MPI, che
+    // stampa i messaggi come il primo processo della farm
+    if(sharedRequested(argc, argv)) {
+      MSL_myId = 0;
+      MSL_numOfTotalProcs = 1;
+      if(!getParameters(argc, argv)) return 1;
+      runShared();
+      return 0;
+    }
+
     // Inizializza la libreria muesli
     InitSkeletons(1, argv);
     
@@ -87,6 +205,16 @@ int main(int argc, char* argv[]) {
       TerminateSkeletons();
       return 1;
     }
+
+    // Benchmark e HashLife: eseguiti dal primo processo, senza la farm
+    if(BENCHMARK || HASHLIFE) {
+      if(MSL_myId == 0) {
+        if(BENCHMARK) runBenchmark();
+        else runHashLife();
+      }
+      TerminateSkeletons();
+      return 0;
+    }
     
     // Inizializza i workers
     initWorkers();
@@ -95,7 +223,7 @@ int main(int argc, char* argv[]) {
     if(MSL_myId == 0) {
       printProgramInfo();
       startTimer();
-      GAME_OF_LIFE_MATRIX = new Matrix(ROWS, COLUMNS, DENSITY);
+      GAME_OF_LIFE_MATRIX = new Matrix(ROWS, COLUMNS, DENSITY, SEED);
     }
     
     // Costruisce la farm
@@ -143,7 +271,8 @@ Block* init(Empty) {
     stopTimer();
     return NULL;
   }
-  Block* block = GAME_OF_LIFE_MATRIX->getBlock(N_WORKERS, count);
+  Block* block = GAME_OF_LIFE_MATRIX->getBlock(N_WORKERS, count,
+      DEPTH * haloColumns());
   count = count + 1;
   return block;
 } // end of function init
@@ -154,23 +283,151 @@ Block* init(Empty) {
   \param input blocco da elaborare
   
   Esegue ITERATIONS iterazioni sul blocco ricevuto in input e restituisce il
-  blocco elaborato. L'output di questa funzione sara' l'input della funzione
-  fin.
+  blocco elaborato. I bordi vengono scambiati ogni DEPTH iterazioni. L'output
+  di questa funzione sara' l'input della funzione fin.
 */
 Block* compute(Block* input) {
   startTimer();
   ProcessorNo leftNeigh, rightNeigh;
   // Cerca i processi "vicini"
   discoverNeighbors(input->getN(), &leftNeigh, &rightNeigh);
-  // Esegue le iterazioni sul blocco, sincronizzandosi alla fine di ognuna.
-  for(int i=0; i < ITERATIONS; ++i) {
-    input->compute();
-    workersSynch(input, leftNeigh, rightNeigh);
+  input->setEngine(ENGINE);
+  // Le fasce vengono riallocate dai thread dopo che sono stati fissati
+  std::vector<int> cpus, nodes;
+  pinWorker(cpus, nodes);
+  input->setThreads(THREADS, PIN_THREADS ||
+      NUMA_POLICY != gameoflife::NUMA_FIRST_TOUCH);
+  if(NUMA_REPORT) reportWorker(input, cpus, nodes);
+  input->setStrip(STRIP_WORDS);
+  input->setTemporal(TEMPORAL);
+  input->setStats(STATS_FILE != NULL);
+  input->setHashing(CYCLES);
+  unsigned long allocations = input->getAllocations();
+  // Il primo worker scrive le statistiche
+  std::vector<gameoflife::Stats> series;
+  std::ofstream* statsOut = NULL;
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORKERS, &rank);
+  if(STATS_FILE != NULL && rank == 0) {
+    statsOut = new std::ofstream(STATS_FILE);
+    (*statsOut) <<"# generation population births deaths top left bottom "
+        <<"right" <<std::endl;
+  }
+  // Esegue le iterazioni sul blocco, sincronizzandosi quando il blocco ha
+  // esaurito le colonne fantasma. Se la matrice si ripete con periodo p,
+  // la generazione ITERATIONS e' uguale alla generazione last, a meno di p
+  // generazioni da quella corrente.
+  std::vector<std::pair<unsigned long, uint64_t> > history;
+  unsigned long last = ITERATIONS;
+  for(unsigned long i=0; i < last; ) {
+    unsigned long n = input->getStepsToSynch();
+    if(n > last - i) n = last - i;
+    // Le statistiche vengono raccolte ad ogni generazione
+    if(STATS_FILE != NULL) n = 1;
+    input->advance(n);
+    i += n;
+    if(STATS_FILE != NULL) {
+      series.push_back(input->getStats());
+      if(series.size() == STATS_EVERY || i == last)
+        reduceStats(series, i - series.size() + 1, statsOut);
+    }
+    if(input->needsSynch()) workersSynch(input, leftNeigh, rightNeigh);
+    if(CYCLES && last == ITERATIONS && input->needsSynch()) {
+      unsigned long period = findCycle(input, i, history);
+      if(period > 0) {
+        last = i + (ITERATIONS - i) % period;
+        if(rank == 0)
+          std::cout <<"Cycle of period " <<period <<" found at generation "
+              <<i <<": generation " <<ITERATIONS <<" is generation " <<last
+              <<"." <<std::endl;
+      }
+    }
   } // end for i
+  delete statsOut;
   stopTimer();
+  SLICE_ALLOCATIONS = input->getAllocations() - allocations;
   return input;
 } // end of function compute
 
+/*!
+  \fn void pinWorker(std::vector<int>& cpus, std::vector<int>& nodes)
+  \brief Fissa i thread del worker alle CPU e ne registra il nodo NUMA
+
+  Con PIN_THREADS fissa il thread t del worker alla CPU consentita di
+  indice l*THREADS+t (vedi gameoflife::pinThread), dove l e' il rango del
+  worker tra quelli dello stesso nodo: cosi' i worker di un nodo non
+  condividono le CPU. I thread sono quelli che OpenMP riutilizza nelle
+  regioni parallele di THREADS thread del blocco. Restituisce in cpus la
+  CPU di ogni thread (-1 se non e' fissato) e in nodes il suo nodo NUMA.
+*/
+void pinWorker(std::vector<int>& cpus, std::vector<int>& nodes) {
+  int local = 0;
+  if(PIN_THREADS) {
+    MPI_Comm node;
+    MPI_Comm_split_type(MPI_COMM_WORKERS, MPI_COMM_TYPE_SHARED, 0,
+        MPI_INFO_NULL, &node);
+    MPI_Comm_rank(node, &local);
+    MPI_Comm_free(&node);
+  }
+  gameoflife::allowedCpus();
+  cpus.assign(THREADS, -1);
+  nodes.assign(THREADS, -1);
+  #pragma omp parallel for num_threads(THREADS) schedule(static, 1)
+  for(unsigned int t=0; t < THREADS; ++t) {
+    if(PIN_THREADS) cpus[t] = gameoflife::pinThread(local * THREADS + t);
+    nodes[t] = gameoflife::currentNumaNode();
+  } // end for t
+  return;
+} // end of function pinWorker
+
+/*!
+  \fn void reportWorker(Block* block, const std::vector<int>& cpus,
+      const std::vector<int>& nodes)
+  \brief Stampa su quali nodi NUMA si trovano le fasce del blocco
+
+  Per ogni fascia di righe del blocco (vedi gameoflife::bandRows) stampa la
+  CPU e il nodo del thread che la calcola (cpus e nodes, vedi pinWorker) e
+  i nodi delle pagine delle sue righe (al massimo 64 campioni).
+*/
+void reportWorker(Block* block, const std::vector<int>& cpus,
+    const std::vector<int>& nodes) {
+  unsigned int rows = block->getRows();
+  unsigned int band = gameoflife::bandRows(rows, THREADS);
+  std::string report;
+  for(unsigned int t=0; t < THREADS && t * band < rows; ++t) {
+    unsigned int first = t * band, last = std::min(first + band, rows);
+    unsigned int step = std::max((last - first) / 64, 1u);
+    std::vector<const void*> samples;
+    for(unsigned int i=first; i < last; i += step)
+      samples.push_back(block->getRow(i));
+    report += placement("PE", MSL_myId, first, last, cpus[t], nodes[t],
+        gameoflife::numaNodeList(samples));
+  } // end for t
+  std::cout <<report <<std::flush;
+  return;
+} // end of function reportWorker
+
+/*!
+  \fn std::string placement(const char* who, unsigned int id,
+      unsigned int first, unsigned int last, int cpu, int node,
+      const std::string& memory)
+  \brief Restituisce la riga del rapporto NUMA di una fascia
+
+  La fascia e' quella delle righe da first a last (escluso) del processo o
+  del thread id (who e' "PE" o "Thread "), calcolata da un thread sulla CPU
+  cpu (-1 se non e' fissato) del nodo node, con le righe sui nodi memory.
+*/
+std::string placement(const char* who, unsigned int id, unsigned int first,
+    unsigned int last, int cpu, int node, const std::string& memory) {
+  std::string line = std::string(who) + std::to_string(id) + " rows " +
+      std::to_string(first) + "-" + std::to_string(last - 1) + ": thread ";
+  line += (cpu < 0 ? std::string("not pinned") :
+      "on cpu " + std::to_string(cpu));
+  line += (node < 0 ? std::string(", node ?") :
+      ", node " + std::to_string(node));
+  return line + " - memory on node " + memory + "\n";
+} // end of function placement
+
 /*!
   \fn void fin(Block* input)
   \brief Funzione eseguita dallo stage finale
@@ -264,19 +521,19 @@ void discoverNeighbors(unsigned int N, ProcessorNo* left, ProcessorNo* right) {
   ed invia i bordi del blocco ai worker vicini.
 */
 void workersSynch(Block* block, ProcessorNo left, ProcessorNo right) {
-  Vector* leftb = block->getLeftBoundary();
-  Vector* rightb = block->getRightBoundary();
-
   // Caso di un solo worker
   if(N_WORKERS == 1) {
-    block->setLeftVector(rightb);
-    block->setRightVector(leftb);
+    selfSynch(block);
     return;
   }
 
+  // I bordi sono vettori del blocco, scritti mentre veniva calcolata
+  // l'ultima generazione
+  Vector* leftb = &block->getLeftBoundary();
+  Vector* rightb = &block->getRightBoundary();
+
   MPI_Status status;
-  Vector* leftv = new Vector();
-  Vector* rightv = new Vector();
+  Vector leftv, rightv;
   
   // I processi con un blocco pari spediscono per primi, quelli con un blocco
   // dispari ricevono per primi.
@@ -284,32 +541,302 @@ void workersSynch(Block* block, ProcessorNo left, ProcessorNo right) {
     // Spedisce il bordo destro al vicino destro
     MSL_Send(right, rightb, 1);
     // Riceve il vettore sinistro dal vicino sinistro
-    MSL_Receive(left, leftv, 1, &status);
+    MSL_Receive(left, &leftv, 1, &status);
     // Spedisce il bordo sinistro al vicino sinistro
     MSL_Send(left, leftb, 1);
     // Riceve il vettore destro dal vicino destro
-    MSL_Receive(right, rightv, 1, &status);
+    MSL_Receive(right, &rightv, 1, &status);
   }
   else {
     // Riceve il vettore sinistro dal vicino sinistro
-    MSL_Receive(left, leftv, 1, &status);
+    MSL_Receive(left, &leftv, 1, &status);
     // Spedisce il bordo destro al vicino destro
     MSL_Send(right, rightb, 1);
     // Riceve il vettore destro dal vicino destro
-    MSL_Receive(right, rightv, 1, &status);
+    MSL_Receive(right, &rightv, 1, &status);
     // Spedisce il bordo sinistro al vicino sinistro
     MSL_Send(left, leftb, 1);
   }
   
-  // Aggiorna i vettori del blocco
+  // Scrive i vettori ricevuti nelle colonne fantasma del blocco
   block->setLeftVector(leftv);
   block->setRightVector(rightv);
-  delete leftb;
-  delete rightb;
   
   return;
 } // end of function workersSynch
 
+/*!
+  \fn void reduceStats(std::vector<gameoflife::Stats>& series,
+      unsigned long first, std::ostream* out)
+  \brief Combina le statistiche dei workers
+  \param series statistiche del blocco delle generazioni da first in poi
+  \param first prima generazione di series
+  \param out stream su cui scrivere le statistiche combinate, NULL per i
+      workers diversi dal primo
+
+  Combina le statistiche di tutti i workers con due riduzioni, una per i
+  contatori e una per i rettangoli delle celle vive, e le scrive su out una
+  generazione per riga. Al termine svuota series.
+*/
+void reduceStats(std::vector<gameoflife::Stats>& series, unsigned long first,
+    std::ostream* out) {
+  unsigned int n = series.size();
+  std::vector<unsigned long> counts(3*n), totalCounts(3*n);
+  std::vector<int> box(4*n), totalBox(4*n);
+  for(unsigned int g=0; g < n; ++g) {
+    counts[3*g] = series[g].population;
+    counts[3*g+1] = series[g].births;
+    counts[3*g+2] = series[g].deaths;
+    // Il massimo di bottom e right e' l'opposto del minimo degli opposti
+    box[4*g] = series[g].top;
+    box[4*g+1] = series[g].left;
+    box[4*g+2] = -series[g].bottom;
+    box[4*g+3] = -series[g].right;
+  } // end for g
+  MPI_Reduce(&counts[0], &totalCounts[0], 3*n, MPI_UNSIGNED_LONG, MPI_SUM, 0,
+      MPI_COMM_WORKERS);
+  MPI_Reduce(&box[0], &totalBox[0], 4*n, MPI_INT, MPI_MIN, 0,
+      MPI_COMM_WORKERS);
+  if(out != NULL) {
+    for(unsigned int g=0; g < n; ++g) {
+      (*out) <<first + g <<" " <<totalCounts[3*g] <<" " <<totalCounts[3*g+1]
+          <<" " <<totalCounts[3*g+2];
+      if(totalCounts[3*g] == 0) (*out) <<" - - - -";
+      else
+        (*out) <<" " <<totalBox[4*g] <<" " <<totalBox[4*g+1] <<" "
+            <<-totalBox[4*g+2] <<" " <<-totalBox[4*g+3];
+      (*out) <<"\n";
+    } // end for g
+    out->flush();
+  }
+  series.clear();
+  return;
+} // end of function reduceStats
+
+/*!
+  \fn unsigned long findCycle(Block* block, unsigned long generation,
+      std::vector<std::pair<unsigned long, uint64_t> >& history)
+  \brief Cerca un ciclo della matrice
+  \param block blocco del worker, alla generazione generation
+  \param generation generazione corrente
+  \param history generazioni e hash della matrice gia' considerati
+  \return il periodo del ciclo, 0 se non e' stato trovato
+
+  Combina gli hash dei blocchi di tutti i workers nell'hash della matrice
+  (vedi Block::getHash) e lo cerca tra gli ultimi CYCLE_HISTORY in history,
+  a cui poi lo aggiunge. Se lo trova, la matrice e' uguale a quella di una
+  generazione precedente, e la differenza tra le due generazioni e' un suo
+  periodo. Tutti i workers ottengono lo stesso risultato.
+*/
+unsigned long findCycle(Block* block, unsigned long generation,
+    std::vector<std::pair<unsigned long, uint64_t> >& history) {
+  uint64_t hash = block->getHash(), total;
+  MPI_Allreduce(&hash, &total, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORKERS);
+  for(unsigned int k=0; k < history.size(); ++k)
+    if(history[k].second == total) return generation - history[k].first;
+  if(history.size() == CYCLE_HISTORY) history.erase(history.begin());
+  history.push_back(std::make_pair(generation, total));
+  return 0;
+} // end of function findCycle
+
+/*!
+  \fn void selfSynch(Block* block)
+  \brief Sincronizzazione di un blocco che copre tutta la matrice
+  \param block blocco da aggiornare
+
+  Il blocco e' vicino di se stesso: il vettore sinistro e' il suo bordo
+  destro e il vettore destro e' il suo bordo sinistro.
+*/
+void selfSynch(Block* block) {
+  block->setLeftVector(block->getRightBoundary());
+  block->setRightVector(block->getLeftBoundary());
+  return;
+} // end of function selfSynch
+
+/*!
+  \fn void runBenchmark()
+  \brief Confronta i motori di calcolo sulla stessa matrice
+
+  Costruisce la matrice iniziale con il seme SEED ed esegue ITERATIONS
+  iterazioni con ogni motore (il motore bitwise con ogni insieme di
+  istruzioni supportato, gli altri con quello scelto), su un unico blocco
+  che copre tutta la matrice.
+  Il motore bitwise viene eseguito sia a righe intere sia a strisce di
+  STRIP_WORDS parole (se diverso da 0).
+  Infine calcola la matrice con ThreadedLife, come con --threads, con THREADS
+  thread (almeno 2).
+  Stampa per ogni motore il tempo impiegato, le celle calcolate al secondo,
+  il rapporto con il motore scalar (e per le strisce con le righe intere) e
+  se la matrice finale coincide con quella del primo motore.
+*/
+void runBenchmark() {
+  Matrix initial(ROWS, COLUMNS, DENSITY, SEED);
+  Matrix* reference = NULL;
+  double base = 0;
+  double cells = double(ROWS) * COLUMNS * ITERATIONS;
+  std::cout <<"Benchmark: " <<ROWS <<"x" <<COLUMNS <<" matrix, density "
+      <<DENSITY <<", seed " <<SEED <<", " <<ITERATIONS <<" iterations, rule "
+      <<gameoflife::ruleName(RULE) <<"." <<std::endl;
+  for(unsigned int e=0; e < gameoflife::ENGINES; ++e) {
+    Engine engine = Engine(e);
+    if(engine == gameoflife::ENGINE_SPARSE &&
+        !gameoflife::sparseSupported(RULE))
+      continue;
+    for(unsigned int x=gameoflife::ISA_NONE; x <= gameoflife::ISA_AVX512; ++x) {
+      Isa isa = Isa(x);
+      if(engine != gameoflife::ENGINE_BITWISE && isa != gameoflife::ISA_NONE)
+        break;
+      if(!gameoflife::isaSupported(isa)) continue;
+      gameoflife::activeIsa() =
+          (engine == gameoflife::ENGINE_BITWISE ? isa : ISA);
+      // Il motore bitwise viene eseguito a righe intere e poi a strisce
+      unsigned int sweeps =
+          (engine == gameoflife::ENGINE_BITWISE && STRIP_WORDS > 0 ? 2 : 1);
+      double rowsTime = 0;
+      for(unsigned int sweep=0; sweep < sweeps; ++sweep) {
+        Block* block = initial.getBlock(1, 0);
+        block->setEngine(engine);
+        block->setStrip(sweep == 0 ? 0 : STRIP_WORDS);
+        startTimer();
+        for(unsigned long i=0; i < ITERATIONS; ++i) {
+          block->compute();
+          selfSynch(block);
+        } // end for i
+        stopTimer();
+        double t = (T_END.tv_sec - T_START.tv_sec) + 
+            (T_END.tv_usec - T_START.tv_usec)/1000000.0;
+        Matrix* result = new Matrix(ROWS, COLUMNS);
+        result->setBlock(block);
+        delete block;
+        if(base == 0) base = t;
+        if(sweep == 0) rowsTime = t;
+        bool same = (reference == NULL || (*result) == (*reference));
+        if(reference == NULL) reference = result;
+        else delete result;
+        std::cout <<"  " <<gameoflife::engineName(engine);
+        if(engine == gameoflife::ENGINE_BITWISE)
+          std::cout <<"/" <<gameoflife::isaName(isa);
+        if(sweep > 0) std::cout <<"/strips of " <<STRIP_WORDS <<" words";
+        std::cout <<": " <<t <<" seconds, " <<cells/t <<" cells/s, x"
+            <<base/t;
+        if(sweep > 0) std::cout <<" (x" <<rowsTime/t <<" over whole rows)";
+        std::cout <<(same ? "" : " - DIFFERENT RESULT") <<std::endl;
+      } // end for sweep
+    } // end for x
+  } // end for e
+  // Lo stesso calcolo con le tessere di ThreadedLife (come con --threads)
+  gameoflife::activeIsa() = ISA;
+  unsigned int threads = std::max(THREADS, 2u);
+  Matrix* result = new Matrix(ROWS, COLUMNS);
+  Block* block = initial.getBlock(1, 0);
+  result->setBlock(block);
+  delete block;
+  startTimer();
+  gameoflife::ThreadedLife(threads).advance(*result, ITERATIONS);
+  stopTimer();
+  double t = (T_END.tv_sec - T_START.tv_sec) +
+      (T_END.tv_usec - T_START.tv_usec)/1000000.0;
+  std::cout <<"  --threads " <<threads <<"/" <<gameoflife::isaName(ISA)
+      <<": " <<t <<" seconds, " <<cells/t <<" cells/s, x" <<base/t
+      <<((*result) == (*reference) ? "" : " - DIFFERENT RESULT") <<std::endl;
+  delete result;
+  delete reference;
+  return;
+} // end of function runBenchmark
+
+/*!
+  \fn void runHashLife()
+  \brief Calcola la matrice finale con HashLife
+
+  Costruisce la matrice iniziale con il seme SEED e calcola direttamente la
+  generazione ITERATIONS con HashLife, su un solo processo. Le generazioni
+  possono essere molte (fino a 2^64-1): il tempo dipende da quanto la
+  matrice si ripete nello spazio e nel tempo, non dal loro numero.
+*/
+void runHashLife() {
+  std::cout <<ROWS <<"x" <<COLUMNS <<" matrix, with density " <<DENSITY
+      <<" (seed " <<SEED <<")." <<std::endl
+      <<ITERATIONS <<" iterations to compute, hashlife engine (" <<HASHLIFE_MB
+      <<" MB), rule " <<gameoflife::ruleName(RULE) <<"." <<std::endl;
+  GAME_OF_LIFE_MATRIX = new Matrix(ROWS, COLUMNS, DENSITY, SEED);
+  if(PRINT_MATRIX)
+    std::cout <<std::endl <<(*GAME_OF_LIFE_MATRIX);
+  startTimer();
+  gameoflife::HashLife hashlife(HASHLIFE_MB);
+  Matrix* result = hashlife.advance(*GAME_OF_LIFE_MATRIX, ITERATIONS);
+  stopTimer();
+  if(PRINT_MATRIX)
+    std::cout <<std::endl <<(*result);
+  if(PRINT_CTIMES) {
+    printComputationTimes();
+    std::cout <<"HashLife: " <<hashlife.getPeakNodes() <<" nodes at most, "
+        <<hashlife.getCollections() <<" garbage collections." <<std::endl;
+  }
+  delete result;
+  delete GAME_OF_LIFE_MATRIX;
+  return;
+} // end of function runHashLife
+
+/*!
+  \fn bool sharedRequested(int argc, char* argv[])
+  \brief Restituisce true se tra gli argomenti c'e' l'opzione --threads
+
+  Viene chiamata prima di inizializzare MPI, per cui non interpreta gli
+  argomenti (lo fa poi getParameters): cerca solo --threads, nelle forme
+  "--threads N" e "--threads=N", fino a un eventuale "--".
+*/
+bool sharedRequested(int argc, char* argv[]) {
+  for(int i=1; i < argc; ++i) {
+    if(strcmp(argv[i], "--") == 0) break;
+    if(strcmp(argv[i], "--threads") == 0 ||
+        strncmp(argv[i], "--threads=", 10) == 0)
+      return true;
+  } // end for i
+  return false;
+} // end of function sharedRequested
+
+/*!
+  \fn void runShared()
+  \brief Calcola la matrice finale in un solo processo con SHARED_THREADS thread
+
+  Costruisce la matrice iniziale e calcola le ITERATIONS generazioni
+  direttamente su di essa con ThreadedLife (motore bitwise), senza MPI,
+  senza farm e senza dividerla in blocchi. Con -t stampa anche il tempo
+  di calcolo e le tessere di ogni thread, e il massimo anticipo raggiunto
+  da una tessera (al massimo LAG generazioni).
+*/
+void runShared() {
+  printProgramInfo();
+  GAME_OF_LIFE_MATRIX = new Matrix(ROWS, COLUMNS, DENSITY, SEED);
+  if(PRINT_MATRIX)
+    std::cout <<std::endl <<(*GAME_OF_LIFE_MATRIX);
+  startTimer();
+  gameoflife::ThreadedLife engine(SHARED_THREADS, LAG);
+  engine.setPinning(PIN_THREADS);
+  engine.advance(*GAME_OF_LIFE_MATRIX, ITERATIONS);
+  stopTimer();
+  for(unsigned int t=0; NUMA_REPORT && t < engine.getThreads(); ++t) {
+    unsigned int first, last;
+    engine.getBand(t, first, last);
+    if(first < last)
+      std::cout <<placement("Thread ", t, first, last, engine.getCpu(t),
+          engine.getNode(t), engine.getMemoryNodes(t));
+  } // end for t
+  if(PRINT_MATRIX)
+    std::cout <<std::endl <<(*GAME_OF_LIFE_MATRIX);
+  if(PRINT_CTIMES) {
+    printComputationTimes();
+    for(unsigned int t=0; t < engine.getThreads(); ++t)
+      std::cout <<"Thread " <<t <<": busy " <<engine.getBusy(t)
+          <<" seconds - " <<engine.getTiles(t) <<" tiles ("
+          <<engine.getStolen(t) <<" stolen)" <<std::endl;
+    std::cout <<"Tiles at most " <<engine.getMaxLag() <<" generations "
+        <<"ahead of the slowest one." <<std::endl;
+  }
+  delete GAME_OF_LIFE_MATRIX;
+  return;
+} // end of function runShared
+
 /*!
   \fn void void startTimer()
   \brief Memorizza i tempi iniziali
@@ -346,16 +873,46 @@ bool getParameters(int argc, char* argv[]) {
   ROWS = 0;
   COLUMNS = 0;
   DENSITY = 0;
+  SEED = time(NULL);
   ITERATIONS = 1;
+  ENGINE = gameoflife::ENGINE_BITWISE;
+  ISA = gameoflife::detectIsa();
+  RULE = gameoflife::CONWAY;
+  LTL_RULE = gameoflife::LtlRule();
+  STRIP_WORDS = gameoflife::detectStripWords();
+  DEPTH = 1;
+  THREADS = 1;
+  SHARED_THREADS = 0;
+  LAG = gameoflife::LAG_LIMIT;
+  NUMA_POLICY = gameoflife::NUMA_FIRST_TOUCH;
+  PIN_THREADS = false;
+  NUMA_REPORT = false;
+  TEMPORAL = false;
   PRINT_MATRIX = false;
   PRINT_CTIMES = false;
+  BENCHMARK = false;
+  HASHLIFE = false;
+  HASHLIFE_MB = gameoflife::HASHLIFE_MEMORY;
+  STATS_FILE = NULL;
+  STATS_EVERY = 1;
+  CYCLES = false;
 
-  // Preleva i parametri
+  // Preleva i parametri (le opzioni lunghe hanno codici oltre i caratteri)
   extern char *optarg;
   extern int optopt;
+  const int THREADS_OPTION = 256, LAG_OPTION = 257, NUMA_OPTION = 258,
+      PIN_OPTION = 259;
+  static const struct option LONG_OPTIONS[] = {
+    { "threads", required_argument, NULL, THREADS_OPTION },
+    { "lag", required_argument, NULL, LAG_OPTION },
+    { "numa", required_argument, NULL, NUMA_OPTION },
+    { "pin", no_argument, NULL, PIN_OPTION },
+    { NULL, 0, NULL, 0 }
+  };
   bool rflg=0, cflg=0, dflg=0, errflg=0;
   int opt;
-  while ((opt = getopt(argc, argv, ":r:c:d:i:pth")) != -1) {
+  while ((opt = getopt_long(argc, argv, ":r:c:d:s:i:e:x:R:w:k:j:m:S:g:CTptbHh",
+      LONG_OPTIONS, NULL)) != -1) {
     switch(opt) {
       case 'r':
         rflg = 1;
@@ -369,8 +926,97 @@ bool getParameters(int argc, char* argv[]) {
         dflg = 1;
         DENSITY = atof(optarg);
         break;
+      case 's':
+        SEED = strtoul(optarg, NULL, 10);
+        break;
       case 'i':
-        ITERATIONS = atoi(optarg);
+        ITERATIONS = strtoul(optarg, NULL, 10);
+        break;
+      case 'e': {
+        bool found = false;
+        for(unsigned int e=0; e < gameoflife::ENGINES; ++e)
+          if(strcmp(optarg, gameoflife::engineName(Engine(e))) == 0) {
+            ENGINE = Engine(e);
+            found = true;
+          }
+        if(!found) {
+          if(MSL_myId == 0)
+            std::cout <<"Unknown engine: " <<optarg <<".\n";
+          errflg = 1;
+        }
+        break;
+      }
+      case 'x':
+        if(strcmp(optarg, "none") == 0) ISA = gameoflife::ISA_NONE;
+        else if(strcmp(optarg, "sse2") == 0) ISA = gameoflife::ISA_SSE2;
+        else if(strcmp(optarg, "avx2") == 0) ISA = gameoflife::ISA_AVX2;
+        else if(strcmp(optarg, "avx512") == 0) ISA = gameoflife::ISA_AVX512;
+        else {
+          if(MSL_myId == 0)
+            std::cout <<"Unknown instruction set: " <<optarg <<".\n";
+          errflg = 1;
+        }
+        break;
+      case 'R':
+        if(gameoflife::parseRule(optarg, RULE))
+          LTL_RULE = gameoflife::LtlRule();
+        else if(!gameoflife::parseLtlRule(optarg, LTL_RULE)) {
+          if(MSL_myId == 0)
+            std::cout <<"Invalid rule: " <<optarg <<".\n";
+          errflg = 1;
+        }
+        break;
+      case 'w':
+        STRIP_WORDS = atoi(optarg);
+        break;
+      case 'k':
+        DEPTH = atoi(optarg);
+        break;
+      case 'j':
+        THREADS = atoi(optarg);
+        break;
+      case THREADS_OPTION:
+        SHARED_THREADS = atoi(optarg);
+        if(SHARED_THREADS < 1) {
+          if(MSL_myId == 0)
+            std::cout <<"The number of threads must be at least 1." <<std::endl;
+          errflg = 1;
+        }
+        break;
+      case LAG_OPTION:
+        LAG = atoi(optarg);
+        if(LAG < 1) {
+          if(MSL_myId == 0)
+            std::cout <<"The lag limit must be at least 1." <<std::endl;
+          errflg = 1;
+        }
+        break;
+      case NUMA_OPTION: {
+        bool found = false;
+        for(unsigned int p=0; p < gameoflife::NUMA_POLICIES; ++p) {
+          gameoflife::NumaPolicy policy = gameoflife::NumaPolicy(p);
+          if(strcmp(optarg, gameoflife::numaPolicyName(policy)) == 0) {
+            NUMA_POLICY = policy;
+            found = true;
+          }
+        } // end for p
+        if(!found) {
+          if(MSL_myId == 0)
+            std::cout <<"Unknown NUMA policy: " <<optarg <<".\n";
+          errflg = 1;
+        }
+        NUMA_REPORT = true;
+        break;
+      }
+      case PIN_OPTION:
+        PIN_THREADS = true;
+        NUMA_REPORT = true;
+        break;
+      case 'T':
+        TEMPORAL = true;
+        break;
+      case 'C':
+        CYCLES = true;
         break;
       case 'p':
         PRINT_MATRIX = true;
@@ -378,11 +1024,29 @@ bool getParameters(int argc, char* argv[]) {
       case 't':
         PRINT_CTIMES = true;
         break;
+      case 'b':
+        BENCHMARK = true;
+        break;
+      case 'H':
+        HASHLIFE = true;
+        break;
+      case 'm':
+        HASHLIFE_MB = strtoul(optarg, NULL, 10);
+        break;
+      case 'S':
+        STATS_FILE = optarg;
+        break;
+      case 'g':
+        STATS_EVERY = strtoul(optarg, NULL, 10);
+        break;
       case 'h':
         errflg = 1;
         break;
       case ':':
-        if(MSL_myId == 0)
+        if(MSL_myId == 0 && optopt >= THREADS_OPTION)
+          std::cout <<"Option --" <<LONG_OPTIONS[optopt - THREADS_OPTION].name
+              <<" requires an operand. \n";
+        else if(MSL_myId == 0)
           std::cout <<"Option -" <<char(optopt) <<" requires an operand. \n";
         errflg = 1;
         break;
@@ -416,28 +1080,130 @@ bool getParameters(int argc, char* argv[]) {
       std::cout <<"Density must be a number between 0 and 1." <<std::endl;
     return false;
   }
-  if(MSL_numOfTotalProcs < 3 || MSL_numOfTotalProcs-2 > COLUMNS) {
+  if(SHARED_THREADS == 0 && !BENCHMARK && !HASHLIFE &&
+      (MSL_numOfTotalProcs < 3 || MSL_numOfTotalProcs-2 > COLUMNS)) {
     if(MSL_myId == 0)
       std::cout <<"Attention, the number of processes MUST BE greater or "
           <<"equals to 3 and at most " <<COLUMNS+2 <<" (i.e. number of "
           <<"columns plus two processes)." <<std::endl;
     return false;
   }
+  if(ENGINE == gameoflife::ENGINE_SPARSE &&
+      !gameoflife::sparseSupported(RULE)) {
+    if(MSL_myId == 0)
+      std::cout <<"The sparse engine does not support rules with B0." 
+          <<std::endl;
+    return false;
+  }
+  if(DEPTH < 1 || (DEPTH > 1 && ENGINE != gameoflife::ENGINE_BITWISE)) {
+    if(MSL_myId == 0)
+      std::cout <<"The halo depth must be at least 1, and greater than 1 "
+          <<"only with the bitwise engine." <<std::endl;
+    return false;
+  }
+  if(LTL_RULE.radius > 0 && (ENGINE != gameoflife::ENGINE_BITWISE ||
+      TEMPORAL || BENCHMARK || HASHLIFE)) {
+    if(MSL_myId == 0)
+      std::cout <<"Larger than Life rules can be used only with the "
+          <<"bitwise engine, without -T, -b and -H." <<std::endl;
+    return false;
+  }
+  if(!BENCHMARK && !HASHLIFE && MSL_numOfTotalProcs >= 3 &&
+      DEPTH * haloColumns() > COLUMNS / (MSL_numOfTotalProcs-2)) {
+    if(MSL_myId == 0)
+      std::cout <<"The halo depth times the radius of the rule can be at "
+          <<"most " <<COLUMNS / (MSL_numOfTotalProcs-2) <<" (i.e. the "
+          <<"number of columns of the smallest block)." <<std::endl;
+    return false;
+  }
+  if(SHARED_THREADS > 0 && (ENGINE != gameoflife::ENGINE_BITWISE ||
+      LTL_RULE.radius > 0 || DEPTH > 1 || THREADS > 1 || TEMPORAL ||
+      STATS_FILE != NULL || CYCLES || BENCHMARK || HASHLIFE)) {
+    if(MSL_myId == 0)
+      std::cout <<"The --threads mode uses the bitwise engine with Bxx/Syy "
+          <<"rules, and can not be used with -k, -j, -T, -S, -C, -b and -H."
+          <<std::endl;
+    return false;
+  }
+  if(SHARED_THREADS == 0 && LAG != gameoflife::LAG_LIMIT) {
+    if(MSL_myId == 0)
+      std::cout <<"The lag limit can be used only with --threads."
+          <<std::endl;
+    return false;
+  }
+  if(THREADS < 1) {
+    if(MSL_myId == 0)
+      std::cout <<"The number of threads must be at least 1." <<std::endl;
+    return false;
+  }
+  if(STATS_FILE != NULL && (TEMPORAL || STATS_EVERY < 1)) {
+    if(MSL_myId == 0)
+      std::cout <<"The statistics must be reduced at least every "
+          <<"generation, and can not be used with -T." <<std::endl;
+    return false;
+  }
+  if(!gameoflife::isaSupported(ISA)) {
+    if(MSL_myId == 0)
+      std::cout <<"The " <<gameoflife::isaName(ISA) <<" instruction set is "
+          <<"not supported by this CPU." <<std::endl;
+    return false;
+  }
+  gameoflife::activeIsa() = ISA;
+  gameoflife::activeRule() = RULE;
+  gameoflife::activeLtlRule() = LTL_RULE;
+  gameoflife::activeNumaPolicy() = NUMA_POLICY;
   if(ITERATIONS <= 0) ITERATIONS = 1;
   
   return true;
 } // end of function getParameters
 
+/*!
+  \fn unsigned int haloColumns()
+  \brief Restituisce le colonne fantasma per lato consumate da una generazione
+
+  Restituisce il raggio della regola Larger than Life LTL_RULE, o 1 se la
+  regola e' RULE.
+*/
+unsigned int haloColumns() {
+  return (LTL_RULE.radius > 0 ? LTL_RULE.radius : 1);
+} // end of function haloColumns
+
+/*!
+  \fn std::string ruleName()
+  \brief Restituisce il nome della regola in uso (LTL_RULE o RULE)
+*/
+std::string ruleName() {
+  if(LTL_RULE.radius > 0) return gameoflife::ltlRuleName(LTL_RULE);
+  return gameoflife::ruleName(RULE);
+} // end of function ruleName
+
 /*!
   \fn void printProgramInfo()
   \brief Stampa su standard output i parametri del programma
 */
 void printProgramInfo() {
-  std::cout <<MSL_numOfTotalProcs <<" process elements, "
-      <<N_WORKERS <<" workers." <<std::endl
-      <<ROWS <<"x" <<COLUMNS <<" matrix, with density " <<DENSITY <<"."
-      <<std::endl
-      <<ITERATIONS <<" iterations to compute." <<std::endl;
+  if(SHARED_THREADS > 0)
+    std::cout <<"Single process, " <<SHARED_THREADS <<" threads (no MPI), "
+        <<"tiles at most " <<LAG <<" iterations ahead." <<std::endl;
+  else
+    std::cout <<MSL_numOfTotalProcs <<" process elements, "
+        <<N_WORKERS <<" workers." <<std::endl;
+  std::cout <<ROWS <<"x" <<COLUMNS <<" matrix, with density " <<DENSITY 
+      <<" (seed " <<SEED <<")." <<std::endl
+      <<ITERATIONS <<" iterations to compute, "
+      <<gameoflife::engineName(ENGINE) <<" engine ("
+      <<gameoflife::isaName(ISA) <<" instructions)." <<std::endl
+      <<"Rule " <<ruleName() <<"." <<std::endl;
+  if(THREADS > 1)
+    std::cout <<THREADS <<" threads per worker." <<std::endl;
+  if(NUMA_REPORT)
+    std::cout <<"NUMA policy " <<gameoflife::numaPolicyName(NUMA_POLICY)
+        <<(PIN_THREADS ? ", threads pinned to the CPUs." : ".") <<std::endl;
+  if(CYCLES)
+    std::cout <<"Looking for cycles of the matrix." <<std::endl;
+  if(DEPTH > 1)
+    std::cout <<"Boundaries exchanged every " <<DEPTH <<" iterations"
+        <<(TEMPORAL ? ", with temporal tiling." : ".") <<std::endl;
   return;
 } // end of function printProgramInfo
 
@@ -450,8 +1216,10 @@ void printComputationTimes() {
   double t2 = T_END.tv_sec+(T_END.tv_usec/1000000.0);
   std::cout <<"PE" <<MSL_myId <<": "
       <<"finish in " <<t2-t1 <<" seconds - "
-      <<"cpu usage " <<((C_END-C_START)/double(CLOCKS_PER_SEC)) <<" seconds" 
-      <<std::endl;
+      <<"cpu usage " <<((C_END-C_START)/double(CLOCKS_PER_SEC)) <<" seconds";
+  if(SLICE_ALLOCATIONS >= 0)
+    std::cout <<" - " <<SLICE_ALLOCATIONS <<" slice allocations";
+  std::cout <<std::endl;
   return;
 } // end of function printComputationTimes
 
@@ -462,6 +1230,7 @@ void printComputationTimes() {
 void printHelp() {
   std::cout <<"Usage: \n"
       <<"  mpiexec -n <procs> ./game-of-life OPTIONS \n"
+      <<"  ./game-of-life --threads <threads> OPTIONS \n"
       <<"Options:\n"
       <<"  <procs>        number of processes for use in computation. "
       <<"At least 3: initial\n"
@@ -473,11 +1242,137 @@ void printHelp() {
       <<"  [-i <iters>]   number of iterations (generations in the Game of "
       <<"Life) to\n"
       <<"                 execute on the matrix. 1 is the default value.\n"
+      <<"  [-s <seed>]    seed used to populate the matrix. The default is "
+      <<"the current\n"
+      <<"                 time.\n"
+      <<"  [-e <engine>]  engine used to compute the generations: scalar "
+      <<"(one cell at\n"
+      <<"                 a time), split (vectorizable loop on the inner "
+      <<"cells, one\n"
+      <<"                 cell at a time on the border), bitwise (64 cells "
+      <<"at a time,\n"
+      <<"                 default), lut (2x2 cells at a time with a lookup "
+      <<"table),\n"
+      <<"                 tiled (bitwise only on the tiles of 32x128 cells "
+      <<"that,\n"
+      <<"                 with their neighbor tiles, are not still or "
+      <<"oscillating with\n"
+      <<"                 period 2), sparse (counts the neighbors only "
+      <<"around the live\n"
+      <<"                 cells) or auto (sparse or tiled depending on the "
+      <<"density of\n"
+      <<"                 the population).\n"
+      <<"  [-R <rule>]    rule of the game in the Bxx/Syy notation: a dead "
+      <<"cell with xx\n"
+      <<"                 live neighbors is born, a live cell with yy live "
+      <<"neighbors\n"
+      <<"                 survives (e.g. B36/S23 for HighLife). The default "
+      <<"is B3/S23.\n"
+      <<"                 The sparse engine does not support rules with "
+      <<"B0. Larger than\n"
+      <<"                 Life rules, with neighborhoods of radius r up to "
+      <<"10, are\n"
+      <<"                 written as Rr,C0,Mm,Ss1..s2,Bb1..b2,NM (e.g. "
+      <<"Bosco's rule\n"
+      <<"                 R5,C0,M1,S34..58,B34..45,NM): a live cell with "
+      <<"s1 to s2 live\n"
+      <<"                 cells in its (2r+1)x(2r+1) neighborhood survives, "
+      <<"a dead cell\n"
+      <<"                 with b1 to b2 is born (the cell itself is counted "
+      <<"if m is 1).\n"
+      <<"                 Blocks then exchange <depth>*r columns on each "
+      <<"side.\n"
+      <<"  [-x <isa>]     instruction set used by the bitwise and tiled "
+      <<"engines: none,\n"
+      <<"                 sse2, avx2 or avx512. The default is the widest one "
+      <<"supported\n"
+      <<"                 by the CPU.\n"
+      <<"  [-w <words>]   width, in words of 64 cells, of the column strips "
+      <<"in which the\n"
+      <<"                 bitwise engine sweeps the blocks (0 sweeps whole "
+      <<"rows). The\n"
+      <<"                 default is sized from the L2 cache.\n"
+      <<"  [-k <depth>]   number of ghost columns on each side of the "
+      <<"blocks: the\n"
+      <<"                 workers exchange their boundaries every <depth> "
+      <<"iterations,\n"
+      <<"                 computing the ghost columns in between. Only with "
+      <<"the bitwise\n"
+      <<"                 engine; 1 is the default value.\n"
+      <<"  [-j <threads>] number of threads of each worker: the bitwise "
+      <<"engine splits\n"
+      <<"                 the rows of the block in one band per thread, "
+      <<"allocated by the\n"
+      <<"                 thread itself. 1 is the default value.\n"
+      <<"  [--threads <threads>]\n"
+      <<"                 runs in a single process, without MPI: "
+      <<"<threads> threads\n"
+      <<"                 compute the tiles of the whole matrix that "
+      <<"changed around\n"
+      <<"                 them with the bitwise engine, stealing tiles from "
+      <<"each other.\n"
+      <<"                 A tile computes the next iteration as soon as it "
+      <<"and its\n"
+      <<"                 neighbors have computed the current one (not with "
+      <<"-e, -k, -j,\n"
+      <<"                 -T, -S, -C, -b, -H and Larger than Life rules).\n"
+      <<"  [--lag <iters>] number of iterations a tile can be ahead of the "
+      <<"slowest one\n"
+      <<"                 (--threads). " <<gameoflife::LAG_LIMIT
+      <<" is the default value.\n"
+      <<"  [--numa <policy>] placement of the pages of the bands of rows "
+      <<"of the threads\n"
+      <<"                 (-j or --threads) on the NUMA nodes: first-touch "
+      <<"(on the node\n"
+      <<"                 of the thread that computes them), local (moved "
+      <<"to that node,\n"
+      <<"                 which is preferred for new pages but not "
+      <<"enforced) or\n"
+      <<"                 interleave (on all the nodes in turn). first-touch "
+      <<"is the\n"
+      <<"                 default value. Prints where the bands are.\n"
+      <<"  [--pin]        pins each thread to a CPU and prints where the "
+      <<"bands are.\n"
+      <<"  [-T]           temporal tiling: the bitwise engine computes the "
+      <<"<depth>\n"
+      <<"                 iterations between two exchanges one cache-sized "
+      <<"tile at a\n"
+      <<"                 time.\n"
+      <<"  [-S <file>]    writes in <file> the population, births, deaths "
+      <<"and bounding\n"
+      <<"                 box of the live cells of each generation. The "
+      <<"workers compute\n"
+      <<"                 them while computing the generation (not with "
+      <<"-T).\n"
+      <<"  [-g <gens>]    number of generations between two reductions of "
+      <<"the\n"
+      <<"                 statistics of the workers (-S). 1 is the default "
+      <<"value.\n"
+      <<"  [-C]           looks for a cycle of the whole matrix, comparing "
+      <<"its hash at\n"
+      <<"                 every exchange with the last " <<CYCLE_HISTORY
+      <<" ones: when the matrix\n"
+      <<"                 repeats with period p, the workers jump to the "
+      <<"last iteration,\n"
+      <<"                 computing only the remaining iterations modulo "
+      <<"p.\n"
       <<"  [-p]           prints on standard output the initial and final "
       <<"matrix.\n"
       <<"  [-t]           calculates and prints on standard output the times "
       <<"of\n"
-      <<"                 computations of each processes.\n"
+      <<"                 computations of each processes and the number of "
+      <<"slices\n"
+      <<"                 allocated by each worker during the iterations.\n"
+      <<"  [-b]           runs every engine on the same matrix in a single "
+      <<"process and\n"
+      <<"                 prints their speed (use -s to repeat it on the "
+      <<"same matrix).\n"
+      <<"  [-H]           computes the final matrix with HashLife in a single "
+      <<"process;\n"
+      <<"                 the number of iterations can be up to 2^64-1.\n"
+      <<"  [-m <MB>]      memory used by HashLife before freeing the nodes "
+      <<"no longer\n"
+      <<"                 needed. 256 is the default value.\n"
       <<"  [-h]           prints this help message."
       <<std::endl;
   return;